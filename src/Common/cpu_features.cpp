@@ -0,0 +1,50 @@
+#include "cpu_features.h"
+
+#if JSON_ARCH_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+bool CpuFeatures::HasSse42()
+{
+  return Get().sse42;
+}
+
+bool CpuFeatures::HasAvx2()
+{
+  return Get().avx2;
+}
+
+const CpuFeatures::Features& CpuFeatures::Get()
+{
+  static const Features features = Detect();
+  return features;
+}
+
+CpuFeatures::Features CpuFeatures::Detect()
+{
+  Features features{ false, false };
+
+#if JSON_ARCH_X86 && defined(_MSC_VER)
+  int info[4] = { 0 };
+
+  __cpuid(info, 0);
+  int max_leaf = info[0];
+
+  __cpuid(info, 1);
+  features.sse42 = (info[2] & (1 << 20)) != 0;
+  bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+  if (max_leaf >= 7 && os_saves_ymm)
+  {
+    __cpuidex(info, 7, 0);
+    features.avx2 = (info[1] & (1 << 5)) != 0;
+  }
+#elif JSON_ARCH_X86
+  __builtin_cpu_init();
+  features.sse42 = __builtin_cpu_supports("sse4.2");
+  features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+  return features;
+}
@@ -0,0 +1,34 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSON_ARCH_X86 1
+#else
+#define JSON_ARCH_X86 0
+#endif
+
+// GCC and Clang need the instruction set enabled per function, MSVC does not
+#if JSON_ARCH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define JSON_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define JSON_TARGET_SSE42
+#define JSON_TARGET_AVX2
+#endif
+
+class CpuFeatures {
+public:
+  static bool HasSse42();
+  static bool HasAvx2();
+
+private:
+  struct Features {
+    bool sse42;
+    bool avx2;
+  };
+
+  static const Features& Get();
+  static Features Detect();
+};
+
+#endif // !CPU_FEATURES_H
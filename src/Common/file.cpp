@@ -2,10 +2,24 @@
 
 #include "file.h"
 
-File::File(const char* path)
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+File::File(const char* path, Mode mode)
   : file_buffer_{""}
   , file_holder_{ fopen(path, "rb"), File::FileDeleter }
   , file_size_{ 0 }
+  , mode_{ mode }
+  , mapped_data_{ nullptr }
+  , mapping_handle_{ nullptr }
 {
   if (file_holder_.get() != NULL) {
     std::cout << "File loaded!" << std::endl;
@@ -15,43 +29,133 @@ File::File(const char* path)
   }
 }
 
+File::~File()
+{
+  Unmap();
+}
+
 bool File::Load()
+{
+  // File exists?
+  if (!file_holder_) return false;
+
+  return mode_ == Mode::Map ? MapContent() : ReadContent();
+}
+
+bool File::ReadContent()
 {
   bool is_file_read = false;
+  FILE* file_ptr = file_holder_.get();
 
-  // File exists?
-  if (file_holder_) {
-    FILE* file_ptr = file_holder_.get();
+  // 64-bit offsets, plain ftell is limited to long
+#ifdef _WIN32
+  auto seek = [](FILE* f, int64_t offset, int origin) { return _fseeki64(f, offset, origin); };
+  auto tell = [](FILE* f) { return static_cast<int64_t>(_ftelli64(f)); };
+#else
+  auto seek = [](FILE* f, int64_t offset, int origin) { return fseeko(f, offset, origin); };
+  auto tell = [](FILE* f) { return static_cast<int64_t>(ftello(f)); };
+#endif
+
+  // Read succesfully?
+  if (seek(file_ptr, 0, SEEK_END) >= 0)
+  {
+    auto position = tell(file_ptr);
 
-    // Read succesfully?
-    if (fseek(file_ptr, 0, SEEK_END) >= 0)
+    // Has any content?
+    if (position >= 0)
     {
-      file_size_ = ftell(file_ptr);
+      file_size_ = static_cast<uint64_t>(position);
 
-      // Has any content?
-      if (file_size_ >= 0)
+      // Stream position correct?
+      if (seek(file_ptr, 0, SEEK_SET) >= 0)
       {
-        // Stream position correct?
-        if (fseek(file_ptr, 0, SEEK_SET) >= 0)
-        {
-          // set size of string buffer
-          file_buffer_.resize(file_size_);
-          // Read data to string
-          fread(file_buffer_.data(), 1, file_size_, file_ptr);
-          is_file_read = true;
-        }
+        // set size of string buffer
+        file_buffer_.resize(file_size_);
+        // Read data to string
+        is_file_read = fread(file_buffer_.data(), 1, file_size_, file_ptr) == file_size_;
       }
     }
   }
   return is_file_read;
 }
 
+bool File::MapContent()
+{
+  Unmap();
+
+#ifdef _WIN32
+  auto file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file_holder_.get())));
+
+  LARGE_INTEGER size;
+  if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &size)) return false;
+  file_size_ = static_cast<uint64_t>(size.QuadPart);
+
+  // Empty files can not be mapped
+  if (file_size_ == 0) return true;
+
+  mapping_handle_ = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping_handle_ == NULL) return false;
+
+  mapped_data_ = static_cast<const char*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (mapped_data_ == nullptr)
+  {
+    Unmap();
+    return false;
+  }
+#else
+  auto descriptor = fileno(file_holder_.get());
+
+  struct stat file_stat;
+  if (fstat(descriptor, &file_stat) != 0) return false;
+  file_size_ = static_cast<uint64_t>(file_stat.st_size);
+
+  // Empty files can not be mapped
+  if (file_size_ == 0) return true;
+
+  auto data = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  if (data == MAP_FAILED) return false;
+
+  // The parser reads the file front to back, let the kernel read ahead
+  madvise(data, file_size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+  madvise(data, file_size_, MADV_HUGEPAGE);
+#endif
+
+  mapped_data_ = static_cast<const char*>(data);
+#endif
+
+  return true;
+}
+
+void File::Unmap()
+{
+#ifdef _WIN32
+  if (mapped_data_ != nullptr) UnmapViewOfFile(mapped_data_);
+  if (mapping_handle_ != nullptr) CloseHandle(mapping_handle_);
+#else
+  if (mapped_data_ != nullptr) munmap(const_cast<char*>(mapped_data_), file_size_);
+#endif
+
+  mapped_data_ = nullptr;
+  mapping_handle_ = nullptr;
+}
+
 const std::string& File::GetContent() const
 {
   return file_buffer_;
 }
 
-size_t File::size() const
+std::string_view File::GetView() const
+{
+  if (mode_ == Mode::Map)
+  {
+    return mapped_data_ != nullptr ? std::string_view(mapped_data_, file_size_) : std::string_view();
+  }
+
+  return file_buffer_;
+}
+
+uint64_t File::size() const
 {
   return file_size_;
 }
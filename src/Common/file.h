@@ -4,25 +4,51 @@
 #include <vector>
 #include <memory>
 #include <string>
-
+#include <string_view>
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * File loaded either into a string buffer (Read) or mapped read-only into
+ * memory (Map). A mapped file is parsed straight from the page cache, the
+ * view stays valid for the lifetime of the File object.
+ */
 class File {
-  
+
 
 public:
-  File(const char* path);
+  enum class Mode {
+    Read,
+    Map
+  };
+
+  File(const char* path, Mode mode = Mode::Read);
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+  ~File();
 
   bool Load();
   const std::string& GetContent() const;
-  size_t size() const;
+  std::string_view GetView() const;
+  uint64_t size() const;
 
 private:
   using FileHolder = std::unique_ptr<FILE, void(*)(FILE*)>;
 
   static void FileDeleter(FILE* f) { fclose(f); }
 
+  bool ReadContent();
+  bool MapContent();
+  void Unmap();
+
   std::string file_buffer_;
   FileHolder file_holder_;
-  size_t file_size_;
+  uint64_t file_size_;
+  Mode mode_;
+
+  /* Mapped view, only used in Map mode */
+  const char* mapped_data_;
+  void* mapping_handle_;
 };
 
 
@@ -0,0 +1,104 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t thread_count)
+  : pending_{ 0 }
+{
+  // hardware_concurrency may be unknown
+  if (thread_count == 0) thread_count = 1;
+
+  workers_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; i++)
+  {
+    workers_.emplace_back([this](std::stop_token stop_token) { WorkerLoop(stop_token); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  for (auto& worker : workers_) worker.request_stop();
+  task_available_.notify_all();
+}
+
+void ThreadPool::Submit(Task task)
+{
+  {
+    std::lock_guard lock(mutex_);
+    tasks_.push_back(std::move(task));
+    pending_++;
+  }
+  task_available_.notify_one();
+}
+
+void ThreadPool::Submit(Group& group, Task task)
+{
+  {
+    std::lock_guard lock(mutex_);
+    group.pending_++;
+  }
+
+  // Finished tasks notify all_done_, the group is counted down before that
+  Submit([this, &group, task = std::move(task)]() {
+    task();
+
+    std::lock_guard lock(mutex_);
+    group.pending_--;
+    });
+}
+
+void ThreadPool::Wait()
+{
+  std::unique_lock lock(mutex_);
+  all_done_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+void ThreadPool::Wait(Group& group)
+{
+  std::unique_lock lock(mutex_);
+
+  while (group.pending_ > 0)
+  {
+    if (tasks_.empty())
+    {
+      all_done_.wait(lock);
+      continue;
+    }
+
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+
+    lock.unlock();
+    task();
+    lock.lock();
+
+    pending_--;
+    all_done_.notify_all();
+  }
+}
+
+size_t ThreadPool::GetThreadCount() const
+{
+  return workers_.size();
+}
+
+void ThreadPool::WorkerLoop(std::stop_token stop_token)
+{
+  while (true)
+  {
+    Task task;
+    {
+      std::unique_lock lock(mutex_);
+      if (!task_available_.wait(lock, stop_token, [this]() { return !tasks_.empty(); })) return;
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+
+    {
+      std::lock_guard lock(mutex_);
+      pending_--;
+    }
+    all_done_.notify_all();
+  }
+}
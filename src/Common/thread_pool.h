@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads taking tasks from a shared queue. Wait()
+ * blocks until every submitted task has finished, Wait(group) only until the
+ * tasks of one group have; a pool can then be shared by several callers.
+ */
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /* Tasks of one caller, it must outlive them */
+  class Group {
+  public:
+    Group() : pending_{ 0 } {}
+    Group(const Group&) = delete;
+    Group& operator=(const Group&) = delete;
+
+  private:
+    size_t pending_;
+
+    friend class ThreadPool;
+  };
+
+  explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  void Submit(Task task);
+  void Submit(Group& group, Task task);
+  void Wait();
+
+  /* Queued tasks are run on the calling thread meanwhile, so a task may wait for a group on its own pool */
+  void Wait(Group& group);
+  size_t GetThreadCount() const;
+
+private:
+  void WorkerLoop(std::stop_token stop_token);
+
+  std::mutex mutex_;
+  std::condition_variable_any task_available_;
+  std::condition_variable all_done_;
+  std::deque<Task> tasks_;
+  size_t pending_;
+  std::vector<std::jthread> workers_;
+};
+
+#endif // !THREAD_POOL_H
@@ -2,253 +2,513 @@
 #include <cctype>
 #include <cassert>
 #include <string>
-#include <format>
 #include <chrono>
 
 #include "json.h"
 #include "json_parser.h"
+#include "json_lines.h"
+#include "json_parallel.h"
+#include "json_key_index.h"
+#include "json_serializer.h"
+#include "json_writer.h"
+
+namespace {
+
+  /* Pool of the parallel parsing methods that are not given one, started on first use */
+  ThreadPool& GetSharedPool()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+}
+
+void JsonDeleter::operator()(Json* json) const
+{
+  // Arena memory is released together with the document, only the strings of a node need its destructor
+  if (json->arena_allocated_) std::destroy_at(json);
+  else delete json;
+}
 
 Json::Json()
-  : key_{ "" }
-  , parent_{ nullptr }
-  , value_type_{ ValueType::Null }
+  : Json("", nullptr, nullptr)
 {
 }
 
-Json::Json(std::string key, Json* parent)
-  : key_{ key }
-  , parent_ { parent }
-  , value_type_{ ValueType::Null }
+Json::Json(std::string_view key, Json* parent)
+  : Json(key, parent, nullptr)
 {
+}
 
+Json::Json(std::string_view key, Json* parent, JsonArena* arena)
+  : parent_{ parent }
+  , arena_{ arena }
+  , key_{ key }
+  , value_type_{ ValueType::Null }
+  , arena_allocated_{ false }
+  , key_interned_{ false }
+  , value_{ std::in_place_type<String> }
+  , key_index_{ nullptr }
+{
 }
 
 Json::Json(const Json& obj)
-: parent_{ nullptr }
-, key_{obj.key_}
-, value_type_{obj.value_type_}
+: Json(obj.GetKey(), nullptr, nullptr)
 {
-  if (std::holds_alternative<String>(obj.value_)) value_ = std::get<String>(obj.value_);
-  if (std::holds_alternative<Number>(obj.value_)) value_ = std::get<Number>(obj.value_);
-  if (std::holds_alternative<Bool>(obj.value_)) value_ = std::get<Bool>(obj.value_);
+  value_type_ = obj.value_type_;
+  CopyValue(obj);
+}
 
-  if (std::holds_alternative<ChildrenList>(obj.value_))
-  {
-    auto& objChildren = std::get<ChildrenList>(obj.value_);
-    
-    value_ = ChildrenList();
-    auto& copyChildren = std::get<ChildrenList>(value_);
-    copyChildren.reserve(objChildren.size());
+Json::Json(Json&& obj) noexcept
+  : parent_{ obj.parent_ }
+  , owned_arena_{ std::move(obj.owned_arena_) }
+  , owned_pool_{ std::move(obj.owned_pool_) }
+  , arena_{ obj.arena_ }
+  , value_type_{ obj.value_type_ }
+  , arena_allocated_{ false }
+  , key_interned_{ obj.key_interned_ }
+  , value_{ std::move(obj.value_) }
+  , key_index_{ obj.key_index_ }
+{
+  if (key_interned_) interned_key_ = obj.interned_key_;
+  else std::construct_at(&key_, std::move(obj.key_));
 
+  // A member of an interned document refers to keys in a pool it does not own
+  if (obj.GetStringPool() != nullptr) ReleaseInternedKeys();
 
-    for (auto& json : objChildren)
-    {
-      copyChildren.push_back(std::make_unique<Json>(*json));
-      copyChildren.back()->parent_ = this;
-    }
+  obj.key_index_ = nullptr;
+  obj.AssignKey(std::string_view(), nullptr);
+  obj.parent_ = nullptr;
+  obj.value_type_ = ValueType::Undefined;
+
+  if (std::holds_alternative<ChildrenList>(value_))
+  {
+    for (auto& child : std::get<ChildrenList>(value_)) child->parent_ = this;
   }
 }
 
-Json::Json(Json&& obj) noexcept
-  : parent_{ nullptr }
-  , key_{ "" }
-  , value_type_{ ValueType::Undefined }
+Json::~Json()
 {
-  std::swap(parent_, obj.parent_);
-  std::swap(key_, obj.key_);
-  std::swap(value_type_, obj.value_type_);
-  std::swap(value_, obj.value_);
+  DropKeyIndex();
+  ReleaseChildren();
+
+  if (!key_interned_) std::destroy_at(&key_);
 }
 
 Json& Json::operator=(const Json& obj)
 {
-  if (std::holds_alternative<String>(obj.value_)) value_ = std::get<String>(obj.value_);
-  if (std::holds_alternative<Number>(obj.value_)) value_ = std::get<Number>(obj.value_);
-  if (std::holds_alternative<Bool>(obj.value_)) value_ = std::get<Bool>(obj.value_);
+  DropKeyIndex();
+  CopyValue(obj);
+
+  return *this;
+}
+
+Json& Json::operator=(Json&& obj) noexcept
+{
+  if (this == &obj) return *this;
+
+  DropKeyIndex();
+  obj.DropKeyIndex();
 
-  if (std::holds_alternative<ChildrenList>(obj.value_))
+  // Both nodes change their keys, the objects they are members of index them again on the next lookup
+  if (parent_ != nullptr) parent_->DropKeyIndex();
+  if (obj.parent_ != nullptr) obj.parent_->DropKeyIndex();
+
+  // A member of another document lives in memory that document keeps, it is copied into the resource of this node
+  if (obj.owned_arena_ == nullptr && obj.GetResource() != GetResource())
   {
-    auto& objChildren = std::get<ChildrenList>(obj.value_);
+    *this = static_cast<const Json&>(obj);
+    AssignKey(obj.GetKey(), nullptr);
+    parent_ = obj.parent_;
+    value_type_ = obj.value_type_;
 
-    value_ = ChildrenList();
-    auto& copyChildren = std::get<ChildrenList>(value_);
-    copyChildren.reserve(objChildren.size());
+    obj.parent_ = nullptr;
+    obj.AssignKey(std::string_view(), nullptr);
+    obj.value_.emplace<String>();
+    obj.value_type_ = ValueType::Undefined;
 
-    for (auto& json : objChildren)
-    {
-      copyChildren.push_back(std::make_unique<Json>(*json));
-      copyChildren.back()->parent_ = this;
-    }
+    return *this;
   }
 
-  return *this;
-}
+  // Moved nodes may refer to keys interned in the other document, a root without a pool takes it along
+  auto root = GetRoot();
+  auto source_pool = obj.GetStringPool();
+  if (root == this && owned_pool_ == nullptr) owned_pool_ = std::move(obj.owned_pool_);
+  auto pool = root->owned_pool_.get();
 
-Json& Json::operator=(Json&& obj) noexcept
-{
   parent_ = obj.parent_;
-  key_ = obj.key_;
   value_type_ = obj.value_type_;
 
+  if (obj.key_interned_) SetInternedKey(obj.interned_key_);
+  else AssignKey(obj.key_, nullptr);
+
+  // The nodes of an arena document go along with the arena, as in the move constructor
+  auto arena = std::move(obj.owned_arena_);
+  auto value = std::move(obj.value_);
+  if (arena != nullptr) obj.arena_ = nullptr;
+
   obj.parent_ = nullptr;
-  obj.key_ = "";
+  obj.AssignKey(std::string_view(), nullptr);
+  obj.value_.emplace<String>();
   obj.value_type_ = ValueType::Undefined;
-  value_ = std::move(obj.value_);
+
+  // Released while arena_ still tells where the old children came from
+  ReleaseChildren();
+
+  if (arena != nullptr)
+  {
+    if (arena_ != nullptr) arena_->Adopt(std::move(arena));
+    else
+    {
+      arena_ = arena.get();
+      owned_arena_ = std::move(arena);
+    }
+  }
+
+  value_ = std::move(value);
+
+  if (std::holds_alternative<ChildrenList>(value_))
+  {
+    for (auto& child : std::get<ChildrenList>(value_)) child->parent_ = this;
+  }
+
+  // Lookups compare keys by the entries of this document's pool, the other pool may not outlive it either
+  if (source_pool != pool) InternKeys(pool);
 
   return *this;
 }
 
 
-std::unique_ptr<Json> Json::Parse(const std::string& data, ProgresCallback progress_callback)
+std::unique_ptr<Json> Json::Parse(std::string_view data, ProgresCallback progress_callback)
+{
+  return Parse(data, ParseOptions(), progress_callback);
+}
+
+std::unique_ptr<Json> Json::Parse(std::string_view data, const ParseOptions& options, ProgresCallback progress_callback)
 {
   JsonParser parser;
-  return parser.Parse(data, progress_callback);
+  return parser.Parse(data, options, progress_callback);
 }
 
+std::unique_ptr<Json> Json::Parse(std::string_view data, const ParseOptions& options, ParseError& error)
+{
+  JsonParser parser;
+  auto json = parser.Parse(data, options, ProgresCallback());
 
-bool Json::SetKey(std::string key)
+  error = parser.GetError();
+  return json;
+}
+
+std::vector<std::unique_ptr<Json>> Json::ParseLines(std::string_view data, const ParseOptions& options)
 {
-  auto parent = this->GetParent();
-  bool key_exists = false;
+  return ParseLines(GetSharedPool(), data, options);
+}
 
-  if (std::holds_alternative<ChildrenList>(parent->value_))
+void Json::ParseLines(std::string_view data, const LineCallback& callback, const ParseOptions& options)
+{
+  ParseLines(GetSharedPool(), data, callback, options);
+}
+
+std::vector<std::unique_ptr<Json>> Json::ParseLines(ThreadPool& pool, std::string_view data, const ParseOptions& options)
+{
+  JsonLinesParser parser(pool, options);
+  return parser.Parse(data);
+}
+
+void Json::ParseLines(ThreadPool& pool, std::string_view data, const LineCallback& callback, const ParseOptions& options)
+{
+  JsonLinesParser parser(pool, options);
+  parser.Parse(data, callback);
+}
+
+std::unique_ptr<Json> Json::ParseParallel(std::string_view data, const ParseOptions& options)
+{
+  // Small documents are not worth starting the pool for
+  if (data.size() < JSON_PARALLEL_MIN_SIZE) return Parse(data, options);
+
+  return ParseParallel(GetSharedPool(), data, options);
+}
+
+std::unique_ptr<Json> Json::ParseParallel(ThreadPool& pool, std::string_view data, const ParseOptions& options)
+{
+  // Small documents are not worth the split
+  if (data.size() < JSON_PARALLEL_MIN_SIZE) return Parse(data, options);
+
+  JsonParallelParser parser(pool, options);
+  return parser.Parse(data);
+}
+
+std::unique_ptr<Json> Json::CreateRoot(const ParseOptions& options)
+{
+  if (!options.use_arena)
   {
-    auto& children = std::get<ChildrenList>(parent->value_);
+    auto root = std::make_unique<Json>("", nullptr);
+    if (options.intern_keys) root->owned_pool_ = std::make_unique<JsonStringPool>();
 
-    for (auto& child : children) {
-      if (child->GetKey() == key) return false;
-    }
+    return root;
+  }
+
+  auto arena = std::make_unique<JsonArena>(options.arena_chunk_size);
+  auto root = std::unique_ptr<Json>(new Json("", nullptr, arena.get()));
+  root->owned_arena_ = std::move(arena);
+  if (options.intern_keys) root->owned_pool_ = std::make_unique<JsonStringPool>();
+
+  return root;
+}
 
+JsonPtr Json::CreateNode(std::string_view key, Json* parent, JsonArena* arena, JsonStringPool* pool)
+{
+  bool intern = pool != nullptr && !key.empty();
+  auto own_key = intern ? std::string_view() : key;
+  JsonPtr node;
+
+  if (arena == nullptr)
+  {
+    node = JsonPtr(new Json(own_key, parent, nullptr));
   }
-  key_ = key_exists ? key_ : key;
-  return true;
+  else
+  {
+    auto memory = arena->allocate(sizeof(Json), alignof(Json));
+    node = JsonPtr(new (memory) Json(own_key, parent, arena));
+    node->arena_allocated_ = true;
+  }
+
+  if (intern) node->SetInternedKey(pool->Intern(key));
+
+  return node;
 }
 
-void Json::SetType(ValueType type)
+JsonPtr Json::CreateChild(std::string_view key, JsonStringPool* pool)
 {
-  value_type_ = type;
+  return CreateNode(key, this, arena_, pool);
 }
 
-void Json::ConvertToArray()
+ChildrenList& Json::EmplaceChildren()
 {
-  std::unique_ptr<Json> copy = std::make_unique<Json>(std::move(*this));
-  this->SetType(ValueType::Array);
-  this->key_ = copy->key_;
-  this->parent_ = copy->parent_;
+  DropKeyIndex();
+  return value_.emplace<ChildrenList>(GetResource());
+}
+
+std::pmr::memory_resource* Json::GetResource() const
+{
+  return arena_ != nullptr ? arena_ : std::pmr::get_default_resource();
+}
+
+JsonKeyIndex* Json::GetKeyIndex()
+{
+  if (value_type_ != ValueType::Object || !std::holds_alternative<ChildrenList>(value_)) return nullptr;
 
-  copy->key_ = "";
-  copy->SetParent(this);
-  this->value_ = ChildrenList();
   auto& children = std::get<ChildrenList>(value_);
+  if (children.size() < JSON_KEY_INDEX_MIN_SIZE) return nullptr;
 
-  children.push_back(std::move(copy));
+  // Members appended by the parsers bypass the index, a count mismatch means a rebuild
+  if (key_index_ == nullptr) key_index_ = JsonKeyIndex::Create(GetResource());
+  if (key_index_->GetMemberCount() != children.size()) key_index_->Build(*this);
+
+  return key_index_;
 }
 
-void Json::ToString(std::string& str) const
+void Json::IndexChild(Json* child)
 {
+  if (key_index_ == nullptr) return;
 
-  switch (value_type_)
-  {
-  case Json::ValueType::String:
-    {
-      auto& value = std::get<String>(value_);
+  if (key_index_->GetMemberCount() + 1 != std::get<ChildrenList>(value_).size()) DropKeyIndex();
+  else key_index_->Insert(child);
+}
 
-      if (IsArrayElement())
-      {
-        str += std::format("\"{}\"", value);
-      }
-      else
-      {
-        str += std::format("\"{}\":\"{}\"", key_, value);
-      }
-    }
-    break;
+void Json::UnindexChild(Json* child)
+{
+  if (key_index_ == nullptr) return;
 
-  case Json::ValueType::Number:
-    {
-      auto& value = std::get<Number>(value_);
+  // A repeated key may have been shadowed by the removed member, start over
+  if (key_index_->HasDuplicates()) DropKeyIndex();
+  else key_index_->Erase(child);
+}
 
-      if (IsArrayElement())
-      {
-        str += std::to_string(value);
-      }
-      else
-      {
-        str += std::format("\"{}\":{}", key_, std::to_string(value));
-      }
-    }
-    break;
+void Json::DropKeyIndex()
+{
+  JsonKeyIndex::Destroy(key_index_);
+  key_index_ = nullptr;
+}
 
-  case Json::ValueType::Bool:
-    {
-      auto& value = std::get<Bool>(value_);
+void Json::CopyValue(const Json& obj)
+{
+  // Subtrees are copied from a worklist of source and copy pairs, so deep documents do not recurse
+  std::vector<std::pair<const Json*, Json*>> pending{ { &obj, this } };
 
-      if (IsArrayElement())
-      {
-        str += (value == true ? "true" : "false");
-      }
-      else
-      {
-        std::string bool_value = value == true ? "true" : "false";
-        str += std::format("\"{}\":{}", key_, bool_value);
-      }
-    }
-    break;
+  while (!pending.empty())
+  {
+    auto [source, copy] = pending.back();
+    pending.pop_back();
 
-  case Json::ValueType::Object:
-    {
-      if (IsArrayElement() || IsRoot())
-      {
-        str.append(1, '{');
-      }
-      else
-      {
-        str += std::format("\"{}\":{{", key_);
-      }
-      
-      ForEachChild([&str](const Json& child) -> void {
-        child.ToString(str);
-        if (!child.IsLastChild()) str.append(1, ',');
-        });
-      str.append(1, '}');
-    }
-    break;
+    auto& value = source->value_;
+    if (std::holds_alternative<String>(value)) copy->value_.emplace<String>(std::get<String>(value));
+    if (std::holds_alternative<Number>(value)) copy->value_ = std::get<Number>(value);
+    if (std::holds_alternative<Bool>(value)) copy->value_ = std::get<Bool>(value);
+    if (std::holds_alternative<Integer>(value)) copy->value_ = std::get<Integer>(value);
+    if (std::holds_alternative<Unsigned>(value)) copy->value_ = std::get<Unsigned>(value);
 
-  case Json::ValueType::Array:
+    if (!std::holds_alternative<ChildrenList>(value)) continue;
 
-    if (IsArrayElement())
-    {
-      str.append(1, '[');
-    }
-    else
+    auto& source_children = std::get<ChildrenList>(value);
+    auto& copy_children = copy->EmplaceChildren();
+    copy_children.reserve(source_children.size());
+
+    for (auto& child : source_children)
     {
-      str += std::format("\"{}\":[", key_);
+      copy_children.push_back(copy->CreateChild(child->GetKey()));
+      copy_children.back()->value_type_ = child->value_type_;
+      pending.emplace_back(child.get(), copy_children.back().get());
     }
+  }
+}
 
-    ForEachChild([&str](const Json& child) -> void {
-      child.ToString(str);
-      if (!child.IsLastChild()) str.append(1, ',');
-      });
-    str.append(1, ']');
-    break;
+void Json::ReleaseChildren()
+{
+  if (!std::holds_alternative<ChildrenList>(value_)) return;
+
+  auto& children = std::get<ChildrenList>(value_);
+  if (children.empty()) return;
 
-  case Json::ValueType::Null:
+  // Nodes are destroyed childless from a worklist, so deep documents do not recurse
+  std::vector<JsonPtr> pending;
+  pending.reserve(children.size());
+  for (auto& child : children) pending.push_back(std::move(child));
+  children.clear();
+
+  while (!pending.empty())
   {
-    if (IsArrayElement())
+    auto node = std::move(pending.back());
+    pending.pop_back();
+
+    // Slots of a failed parallel parse may be empty, a node holding an arena releases its own children
+    if (node != nullptr && node->owned_arena_ == nullptr && std::holds_alternative<ChildrenList>(node->value_))
     {
-      str += "null";
+      auto& list = std::get<ChildrenList>(node->value_);
+      for (auto& child : list) pending.push_back(std::move(child));
+      list.clear();
     }
-    else
-    {
-      str += std::format("\"{}\":null", key_);
+  }
+}
+
+bool Json::SetKey(std::string key)
+{
+  return SetKey(key, nullptr);
+}
+
+bool Json::SetKey(std::string_view key, JsonStringPool* pool)
+{
+  auto parent = this->GetParent();
+  bool key_exists = false;
+
+  if (parent == nullptr)
+  {
+    AssignKey(key, pool);
+    return true;
+  }
+
+  auto index = parent->GetKeyIndex();
+
+  if (index != nullptr && !index->HasDuplicates())
+  {
+    if (index->Find(key) != nullptr) return false;
+
+    index->Erase(this);
+    AssignKey(key, pool);
+    index->Insert(this);
+    return true;
+  }
+
+  if (std::holds_alternative<ChildrenList>(parent->value_))
+  {
+    auto& children = std::get<ChildrenList>(parent->value_);
+
+    for (auto& child : children) {
+      if (child->GetKey() == key) return false;
     }
+
+  }
+  if (!key_exists) AssignKey(key, pool);
+  parent->DropKeyIndex();
+  return true;
+}
+
+void Json::AssignKey(std::string_view key, JsonStringPool* pool)
+{
+  if (pool != nullptr && !key.empty())
+  {
+    SetInternedKey(pool->Intern(key));
+  }
+  else if (key_interned_)
+  {
+    std::construct_at(&key_, key);
+    key_interned_ = false;
+  }
+  else
+  {
+    key_.assign(key);
+  }
+}
+
+void Json::SetInternedKey(const String* key)
+{
+  if (!key_interned_)
+  {
+    std::destroy_at(&key_);
+    key_interned_ = true;
+  }
+
+  interned_key_ = key;
+}
+
+void Json::InternKeys(JsonStringPool* pool)
+{
+  // Interned keys of the subtree are moved to the pool, or into the nodes when there is none
+  std::vector<Json*> pending{ this };
+
+  while (!pending.empty())
+  {
+    auto node = pending.back();
+    pending.pop_back();
+
+    if (node->key_interned_) node->AssignKey(*node->interned_key_, pool);
+    if (!std::holds_alternative<ChildrenList>(node->value_)) continue;
+
+    for (auto& child : std::get<ChildrenList>(node->value_)) pending.push_back(child.get());
   }
-    break;
+}
+
+void Json::ReleaseInternedKeys()
+{
+  InternKeys(nullptr);
+}
+
+bool Json::HasKey(std::string_view key, const String* interned) const
+{
+  if (key_interned_ && interned != nullptr) return interned_key_ == interned;
+  return GetKey() == key;
+}
+
+void Json::SetType(ValueType type)
+{
+  value_type_ = type;
+}
 
-  default:
-    str.clear();
-    return;
+void Json::ConvertToArray()
+{
+  JsonPtr copy = CreateChild("");
+  copy->value_type_ = value_type_;
+  copy->value_ = std::move(value_);
+
+  if (std::holds_alternative<ChildrenList>(copy->value_))
+  {
+    for (auto& child : std::get<ChildrenList>(copy->value_)) child->parent_ = copy.get();
   }
+
+  this->SetType(ValueType::Array);
+  auto& children = EmplaceChildren();
+
+  children.push_back(std::move(copy));
 }
 
 Json::ValueType Json::GetType() const
@@ -258,7 +518,7 @@ Json::ValueType Json::GetType() const
 
 const std::string& Json::GetKey() const
 {
-  return key_;
+  return key_interned_ ? *interned_key_ : key_;
 }
 
 Json* Json::GetParent() const
@@ -271,6 +531,54 @@ const JsonValue& Json::GetValue() const
   return value_;
 }
 
+const JsonArena* Json::GetArena() const
+{
+  return arena_;
+}
+
+const JsonStringPool* Json::GetStringPool() const
+{
+  auto node = this;
+  while (node->parent_ != nullptr) node = node->parent_;
+
+  return node->owned_pool_.get();
+}
+
+std::string_view Json::GetString() const
+{
+  if (std::holds_alternative<String>(value_)) return std::get<String>(value_);
+  return std::string_view();
+}
+
+bool Json::IsInteger() const
+{
+  return std::holds_alternative<Integer>(value_) || std::holds_alternative<Unsigned>(value_);
+}
+
+Number Json::GetNumber() const
+{
+  if (std::holds_alternative<Number>(value_)) return std::get<Number>(value_);
+  if (std::holds_alternative<Integer>(value_)) return static_cast<Number>(std::get<Integer>(value_));
+  if (std::holds_alternative<Unsigned>(value_)) return static_cast<Number>(std::get<Unsigned>(value_));
+  return Number();
+}
+
+Integer Json::GetInt64() const
+{
+  if (std::holds_alternative<Integer>(value_)) return std::get<Integer>(value_);
+  if (std::holds_alternative<Unsigned>(value_)) return static_cast<Integer>(std::get<Unsigned>(value_));
+  if (std::holds_alternative<Number>(value_)) return static_cast<Integer>(std::get<Number>(value_));
+  return Integer();
+}
+
+Unsigned Json::GetUInt64() const
+{
+  if (std::holds_alternative<Unsigned>(value_)) return std::get<Unsigned>(value_);
+  if (std::holds_alternative<Integer>(value_)) return static_cast<Unsigned>(std::get<Integer>(value_));
+  if (std::holds_alternative<Number>(value_)) return static_cast<Unsigned>(std::get<Number>(value_));
+  return Unsigned();
+}
+
 void Json::SetParent(Json* parent)
 {
   parent_ = parent;
@@ -284,7 +592,8 @@ void Json::SetValue(bool data)
 
 void Json::ClearValue()
 {
-  value_ = JsonValue();
+  DropKeyIndex();
+  value_.emplace<String>();
   value_type_ = ValueType::Null;
 }
 
@@ -295,6 +604,7 @@ std::unique_ptr<Json> Json::Detach()
   std::unique_ptr<Json> json;
 
   auto parent = this->GetParent();
+  bool interned = GetStringPool() != nullptr;
 
   auto& value = parent->value_;
 
@@ -306,8 +616,23 @@ std::unique_ptr<Json> Json::Detach()
     {
       if (it->get() == this)
       {
-        json = std::unique_ptr<Json>(it->release());
-        children.erase(it);
+        parent->UnindexChild(this);
+
+        if (arena_allocated_)
+        {
+          // Arena memory dies with the document, hand out a heap copy instead
+          json = std::make_unique<Json>(*this);
+          children.erase(it);
+        }
+        else
+        {
+          json = std::unique_ptr<Json>(it->release());
+          json->parent_ = nullptr;
+          children.erase(it);
+
+          // The detached subtree outlives the pool of the document
+          if (interned) json->ReleaseInternedKeys();
+        }
         return json;
       }
     }
@@ -321,6 +646,7 @@ bool Json::RemoveChild(int index)
   if (!std::holds_alternative<ChildrenList>(value_)) return false;
 
   auto& children = std::get<ChildrenList>(value_);
+  UnindexChild(children[index].get());
   children.erase(std::begin(children) + index);
 
   return true;
@@ -364,9 +690,17 @@ Json* Json::operator[](std::string_view key)
   if (value_type_ != ValueType::Object) return nullptr;
   if (!std::holds_alternative<ChildrenList>(value_)) return nullptr;
 
-  for (auto& child : std::get<ChildrenList>(value_))
+  auto& children = std::get<ChildrenList>(value_);
+
+  // Members parsed into an interned document share the pool entries, the lookup key is found in the pool once
+  const String* interned = nullptr;
+  if (!children.empty() && children.front()->key_interned_) interned = GetStringPool()->Find(key);
+
+  if (auto index = GetKeyIndex()) return index->Find(key, interned);
+
+  for (auto& child : children)
   {
-    if (child->GetKey() == key) return child.get();
+    if (child->HasKey(key, interned)) return child.get();
   }
 
   return nullptr;
@@ -382,25 +716,32 @@ Json* Json::operator[](int index)
   return std::get<ChildrenList>(value_)[index].get();
 }
 
-void Json::ForEachChild(const std::function<void(const Json&)>& function) const
+std::string Json::ToString(const SerializeOptions& options) const
 {
-  if (std::holds_alternative<ChildrenList>(value_))
-  {
-    auto& children = std::get<ChildrenList>(value_);
+  std::string json_string;
 
-    for (auto& element : children)
-    {
-      function(*element);
-    }
-  }
+  JsonSerializer serializer(json_string, options);
+  serializer.Serialize(*this);
+  serializer.Finish();
+
+  return json_string;
 }
 
-std::string Json::ToString() const
+bool Json::WriteTo(FILE* file, const SerializeOptions& options) const
 {
-  std::string json_string;
+  return WriteTo(JsonWriter::FileCallback(file), options);
+}
+
+bool Json::WriteTo(int fd, const SerializeOptions& options) const
+{
+  return WriteTo(JsonWriter::DescriptorCallback(fd), options);
+}
 
-  this->ToString(json_string);
+bool Json::WriteTo(const WriteCallback& callback, const SerializeOptions& options) const
+{
+  JsonSerializer serializer(callback, options);
+  serializer.Serialize(*this);
 
-  return json_string;
+  return serializer.Finish();
 }
 
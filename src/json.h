@@ -3,31 +3,105 @@
 
 #include <string>
 #include <vector>
+#include <list>
+#include <atomic>
+#include <algorithm>
 #include <concepts>
 #include <memory>
+#include <iterator>
+#include <ranges>
+#include <span>
 #include <variant>
 #include <any>
 #include <functional>
 #include <utility>
 #include <type_traits>
+#include <memory_resource>
+#include <string_view>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+
+#include "json_arena.h"
+#include "json_progress.h"
+#include "json_string_pool.h"
+#include "thread_pool.h"
+
+/* Child lists searched by the thread pool, smaller ones are not worth the tasks */
+#define JSON_FIND_PARALLEL_MIN_CHILDREN 1024
+#define JSON_FIND_TASKS_PER_THREAD 4
 
 class Json;
+class JsonKeyIndex;
+
+template<bool Const>
+class JsonDescendants;
+
+struct JsonDeleter {
+  void operator()(Json* json) const;
+};
 
 template<typename T, typename... U>
 concept any_of = std::disjunction_v<std::is_same<T, U>...>;
 
 template<typename T>
-concept Arithmetic = std::is_arithmetic_v<T>;
+concept Arithmetic = std::is_arithmetic_v<std::remove_cvref_t<T>>;
 
-using ChildrenList = std::vector<std::unique_ptr<Json>>;
+using JsonPtr = std::unique_ptr<Json, JsonDeleter>;
+using ChildrenList = std::pmr::vector<JsonPtr>;
 using Bool = bool;
 using Number = double;
+using Integer = int64_t;
+using Unsigned = uint64_t;
 using String = std::string;
-using Array = std::vector<std::unique_ptr<Json>>;
+using Array = std::pmr::vector<JsonPtr>;
+
+using JsonValue = std::variant<String, Number, Bool, ChildrenList, Integer, Unsigned>;
 
-using JsonValue = std::variant<String, Number, Bool, ChildrenList>;
+using LineCallback = std::function<void(size_t, std::unique_ptr<Json>)>;
+using WriteCallback = std::function<bool(std::string_view)>;
 
-using ProgresCallback = std::function<bool(size_t)>;
+struct ParseOptions {
+  /* Allocate nodes and child lists from an arena owned by the root, strings stay std::string in every mode */
+  bool use_arena = false;
+  size_t arena_chunk_size = JSON_ARENA_DEFAULT_CHUNK_SIZE;
+
+  /* Share one copy of every distinct object key between the nodes of the document, it saves the allocation of keys past the 15 character small string buffer */
+  bool intern_keys = false;
+
+  /* Bytes parsed between progress updates and cancellation checks */
+  size_t progress_interval = JSON_PROGRESS_INTERVAL;
+
+  /* Report progress from the shared reporter thread instead of the parsing thread */
+  bool progress_reporter = false;
+
+  /* Limits for untrusted input, zero means unlimited. Allocated bytes are exact for the arena of arena documents, strings and heap nodes are counted from their sizes */
+  size_t max_depth = 0;
+  size_t max_input_size = 0;
+  size_t max_nodes = 0;
+  size_t max_allocated_bytes = 0;
+
+  /* Checked every progress interval */
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+/* Why Json::Parse returned an Undefined document */
+enum class ParseError {
+  None,
+  Syntax,
+  Cancelled,
+  DepthLimit,
+  SizeLimit,
+  NodeLimit,
+  MemoryLimit,
+  Deadline,
+};
+
+struct SerializeOptions {
+  /* One member or element per line, indented by the given number of spaces per level */
+  bool pretty = false;
+  size_t indent = 2;
+};
 
 template<class T>
 concept StringLike = std::is_convertible_v<T, std::string_view>;
@@ -54,18 +128,29 @@ public:
   };
 
   Json();
-  Json(std::string key, Json* parent);
+  Json(std::string_view key, Json* parent);
   Json(const Json& obj);
   Json(Json&& obj) noexcept;
   Json& operator=(const Json& obj);
   Json& operator=(Json&& obj) noexcept;
-  ~Json() = default;
+  ~Json();
 
   /* Accessors and mutators */
   Json::ValueType GetType() const;
   const std::string& GetKey() const;
   Json* GetParent() const;
   const JsonValue& GetValue() const;
+  const JsonArena* GetArena() const;
+  const JsonStringPool* GetStringPool() const;
+
+  /* Contents of a string value, empty for other types */
+  std::string_view GetString() const;
+
+  /* Typed number accessors, they convert between the number representations */
+  bool IsInteger() const;
+  Number GetNumber() const;
+  Integer GetInt64() const;
+  Unsigned GetUInt64() const;
 
   bool SetKey(std::string name);
   void SetParent(Json* parent);
@@ -98,75 +183,245 @@ public:
   template<typename T>
   Json* AddValue(T&& data);
 
-  void ForEachChild(const std::function<void(const Json&)>& function) const;
+  /* Visitors are called directly, without a std::function in between */
+  template<class T> requires std::invocable<T&, Json&>
+  void ForEachChild(T&& visitor);
+
+  template<class T> requires std::invocable<T&, const Json&>
+  void ForEachChild(T&& visitor) const;
+
+  /* Lazy views for the range adaptors; descendants and leaves are in pre-order and exclude the node itself */
+  auto Children();
+  auto Children() const;
+  JsonDescendants<false> Descendants();
+  JsonDescendants<true> Descendants() const;
+  auto Leaves();
+  auto Leaves() const;
 
   /* Json conversion to string */
-  std::string ToString() const;
+  std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  /* Streamed through a fixed-size buffer, false when the destination fails */
+  bool WriteTo(FILE* file, const SerializeOptions& options = SerializeOptions()) const;
+  bool WriteTo(int fd, const SerializeOptions& options = SerializeOptions()) const;
+  bool WriteTo(const WriteCallback& callback, const SerializeOptions& options = SerializeOptions()) const;
 
-  /* Searching methods */
+  /* Searching methods without recursion; FindIf stops at the first match in pre-order */
   template<Predicate T>
   Json* FindIf(const T& predicate);
 
+  /* Matches in post-order, the children of a node are listed before it */
   template<Predicate T>
-  std::list<Json*> FindAllIf(const T& predicate)
-  {
-    std::list<Json*> list;
+  std::list<Json*> FindAllIf(const T& predicate);
 
-    auto result = predicate(*this);
-    if (result) list.push_back(this);
+  /* Matches in pre-order (document order), found is cleared first so one vector can serve many searches */
+  template<Predicate T>
+  void FindAllIf(const T& predicate, std::vector<Json*>& found);
 
-    std::list<Json*> children_list;
+  /* Child lists of at least JSON_FIND_PARALLEL_MIN_CHILDREN nodes are searched by the pool, the predicate must be thread safe */
+  template<Predicate T>
+  Json* FindIf(ThreadPool& pool, const T& predicate);
 
-    if (std::holds_alternative<ChildrenList>(value_))
-    {
-      auto& children = std::get<ChildrenList>(value_);
-      for (auto& element : children)
-      {
-        children_list.splice(children_list.end(), element->FindAllIf(predicate));
-      }
-    }
+  template<Predicate T>
+  void FindAllIf(ThreadPool& pool, const T& predicate, std::vector<Json*>& found);
 
-    children_list.splice(children_list.end(), list);
+  /* Parsing methods */
+  static std::unique_ptr<Json> Parse(std::string_view data, const ProgresCallback = ProgresCallback());
+  static std::unique_ptr<Json> Parse(std::string_view data, const ParseOptions& options, const ProgresCallback = ProgresCallback());
+  static std::unique_ptr<Json> Parse(std::string_view data, const ParseOptions& options, ParseError& error);
 
-    return children_list;
-  }
+  /* Newline delimited documents parsed in parallel, in input order; blank lines are skipped */
+  static std::vector<std::unique_ptr<Json>> ParseLines(std::string_view data, const ParseOptions& options = ParseOptions());
+  static void ParseLines(std::string_view data, const LineCallback& callback, const ParseOptions& options = ParseOptions());
+  static std::vector<std::unique_ptr<Json>> ParseLines(ThreadPool& pool, std::string_view data, const ParseOptions& options = ParseOptions());
+  static void ParseLines(ThreadPool& pool, std::string_view data, const LineCallback& callback, const ParseOptions& options = ParseOptions());
 
-  /* Parsing methods */
-  static std::unique_ptr<Json> Parse(const std::string& data, const ProgresCallback = ProgresCallback());
+  /* Large documents split at container elements and parsed on all cores */
+  static std::unique_ptr<Json> ParseParallel(std::string_view data, const ParseOptions& options = ParseOptions());
+  static std::unique_ptr<Json> ParseParallel(ThreadPool& pool, std::string_view data, const ParseOptions& options = ParseOptions());
 
 private:
 
+  Json(std::string_view key, Json* parent, JsonArena* arena);
+
   /* Accessors and mutators */
   void SetType(ValueType type);
   void ConvertToArray();
+  bool SetKey(std::string_view key, JsonStringPool* pool);
+  void AssignKey(std::string_view key, JsonStringPool* pool);
+  void SetInternedKey(const String* key);
+  void InternKeys(JsonStringPool* pool);
+  void ReleaseInternedKeys();
+
+  /* Keys interned by the document are compared by pool entry, interned is the entry of the lookup key if it has one */
+  bool HasKey(std::string_view key, const String* interned) const;
+
+  /* Allocation helpers, they keep the whole document in one arena */
+  static std::unique_ptr<Json> CreateRoot(const ParseOptions& options);
+  static JsonPtr CreateNode(std::string_view key, Json* parent, JsonArena* arena, JsonStringPool* pool = nullptr);
+  JsonPtr CreateChild(std::string_view key, JsonStringPool* pool = nullptr);
+  ChildrenList& EmplaceChildren();
+  std::pmr::memory_resource* GetResource() const;
+
+  /* Search helpers, found is nullptr when only the first match is wanted */
+  template<Predicate T>
+  static Json* Search(Json* root, const T& predicate, std::vector<Json*>* found, std::vector<Json*>& pending);
 
-  /* Json conversion to string */
-  void ToString(std::string& str) const;
+  template<Predicate T>
+  Json* SearchParallel(ThreadPool& pool, const T& predicate, std::vector<Json*>* found);
+
+  /* Scalars and empty containers */
+  static bool IsLeaf(const Json& node);
+
+  /* Key index of large objects, built on the first lookup */
+  JsonKeyIndex* GetKeyIndex();
+  void IndexChild(Json* child);
+  void UnindexChild(Json* child);
+  void DropKeyIndex();
+  void ReleaseChildren();
+  void CopyValue(const Json& obj);
 
   Json* parent_;
-  std::string key_;
+
+  // Only the root of an arena document owns it, every node points at it
+  std::unique_ptr<JsonArena> owned_arena_;
+  std::unique_ptr<JsonStringPool> owned_pool_;
+  JsonArena* arena_;
+
+  // Interned keys point into the pool of the document and take no storage in the node
+  union {
+    String key_;
+    const String* interned_key_;
+  };
 
   //Values
   ValueType value_type_;
+  bool arena_allocated_;
+  bool key_interned_;
   JsonValue value_;
 
+  JsonKeyIndex* key_index_;
+
   friend class JsonParser;
+  friend class JsonParallelParser;
+  friend class JsonKeyIndex;
+  friend struct JsonDeleter;
+};
+
+
+/*
+ * Pre-order iterator over the subtree below a node. It keeps the remaining
+ * child slots of every open level, so the walk needs neither recursion nor a
+ * list of the visited nodes.
+ */
+template<bool Const>
+class JsonDescendantIterator {
+public:
+  using value_type = Json;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<Const, const Json&, Json&>;
+  using pointer = std::conditional_t<Const, const Json*, Json*>;
+  using iterator_category = std::forward_iterator_tag;
+
+  JsonDescendantIterator() = default;
+  explicit JsonDescendantIterator(const Json& root);
+
+  reference operator*() const { return **levels_.back().first; }
+  pointer operator->() const { return levels_.back().first->get(); }
+
+  JsonDescendantIterator& operator++();
+  JsonDescendantIterator operator++(int);
+
+  bool operator==(const JsonDescendantIterator& other) const;
+  bool operator==(std::default_sentinel_t) const { return levels_.empty(); }
+
+private:
+  bool Enter(const Json& node);
+
+  std::vector<std::pair<const JsonPtr*, const JsonPtr*>> levels_;
 };
 
+template<bool Const>
+class JsonDescendants : public std::ranges::view_interface<JsonDescendants<Const>> {
+public:
+  JsonDescendants() : root_{ nullptr } {}
+  explicit JsonDescendants(const Json* root) : root_{ root } {}
+
+  JsonDescendantIterator<Const> begin() const { return root_ ? JsonDescendantIterator<Const>(*root_) : JsonDescendantIterator<Const>(); }
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+  const Json* root_;
+};
+
+
+template<bool Const>
+JsonDescendantIterator<Const>::JsonDescendantIterator(const Json& root)
+{
+  Enter(root);
+}
+
+template<bool Const>
+JsonDescendantIterator<Const>& JsonDescendantIterator<Const>::operator++()
+{
+  // Children come right after their parent, then the next sibling of the closest open level
+  if (Enter(**levels_.back().first)) return *this;
+
+  while (!levels_.empty() && ++levels_.back().first == levels_.back().second) levels_.pop_back();
+  return *this;
+}
+
+template<bool Const>
+JsonDescendantIterator<Const> JsonDescendantIterator<Const>::operator++(int)
+{
+  auto previous = *this;
+  ++*this;
+  return previous;
+}
+
+template<bool Const>
+bool JsonDescendantIterator<Const>::operator==(const JsonDescendantIterator& other) const
+{
+  if (levels_.empty() || other.levels_.empty()) return levels_.empty() == other.levels_.empty();
+  return levels_.back().first == other.levels_.back().first;
+}
+
+template<bool Const>
+bool JsonDescendantIterator<Const>::Enter(const Json& node)
+{
+  auto children = std::get_if<ChildrenList>(&node.GetValue());
+  if (children == nullptr || children->empty()) return false;
+
+  levels_.emplace_back(children->data(), children->data() + children->size());
+  return true;
+}
+
 
 template<StringLike T>
 void Json::SetValue(T&& data) {
-  value_ = std::string(std::forward<T>(data));
+  value_.emplace<String>(std::string_view(std::forward<T>(data)));
   value_type_ = ValueType::String;
 }
 
 template<Arithmetic T>
 void Json::SetValue(T&& data) {
-  if (std::is_same_v<T, bool>)
+  using Type = std::remove_cvref_t<T>;
+
+  if constexpr (std::is_same_v<Type, bool>)
   {
     value_ = static_cast<bool>(std::forward<T>(data));
     value_type_ = ValueType::Bool;
   }
+  else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+  {
+    value_ = static_cast<Integer>(std::forward<T>(data));
+    value_type_ = ValueType::Number;
+  }
+  else if constexpr (std::is_integral_v<Type>)
+  {
+    value_ = static_cast<Unsigned>(std::forward<T>(data));
+    value_type_ = ValueType::Number;
+  }
   else {
     value_ = static_cast<double>(std::forward<T>(data));
     value_type_ = ValueType::Number;
@@ -182,18 +437,16 @@ Json* Json::AddChild(T&& data, std::string key)
   if (!std::holds_alternative<ChildrenList>(value_))
   {
     value_type_ = ValueType::Object;
-    value_ = ChildrenList();
+    EmplaceChildren();
   }
 
   auto& children = std::get<ChildrenList>(value_);
-  children.push_back(std::make_unique<Json>());
+  children.push_back(CreateChild(key));
 
   auto& newObj = *children.back();
-
-  newObj.parent_ = this;
-  newObj.key_ = key;
   
   newObj.SetValue(std::forward<T>(data));
+  IndexChild(&newObj);
 
   return &newObj;
 }
@@ -204,7 +457,7 @@ Json* Json::AddValue(T&& data)
   if (value_type_ == ValueType::Null)
   {
     value_type_ = ValueType::Array;
-    value_ = ChildrenList();
+    EmplaceChildren();
   }
 
   if (value_type_ != ValueType::Array) ConvertToArray();
@@ -212,9 +465,8 @@ Json* Json::AddValue(T&& data)
   if (std::holds_alternative<ChildrenList>(value_))
   {
     auto& children = std::get<ChildrenList>(value_);
-    children.push_back(std::make_unique<Json>());
+    children.push_back(CreateChild(""));
     children.back()->SetValue(std::forward<T>(data));
-    children.back()->SetParent(this);
 
     return children.back().get();
   }
@@ -222,26 +474,214 @@ Json* Json::AddValue(T&& data)
   return nullptr;
 }
 
+template<class T> requires std::invocable<T&, Json&>
+void Json::ForEachChild(T&& visitor)
+{
+  if (!std::holds_alternative<ChildrenList>(value_)) return;
+  for (auto& child : std::get<ChildrenList>(value_)) visitor(*child);
+}
+
+template<class T> requires std::invocable<T&, const Json&>
+void Json::ForEachChild(T&& visitor) const
+{
+  if (!std::holds_alternative<ChildrenList>(value_)) return;
+  for (auto& child : std::get<ChildrenList>(value_)) visitor(static_cast<const Json&>(*child));
+}
+
+inline auto Json::Children()
+{
+  std::span<JsonPtr> children;
+  if (std::holds_alternative<ChildrenList>(value_)) children = std::get<ChildrenList>(value_);
+
+  return children | std::views::transform([](JsonPtr& child) -> Json& { return *child; });
+}
+
+inline auto Json::Children() const
+{
+  std::span<const JsonPtr> children;
+  if (std::holds_alternative<ChildrenList>(value_)) children = std::get<ChildrenList>(value_);
+
+  return children | std::views::transform([](const JsonPtr& child) -> const Json& { return *child; });
+}
+
+inline JsonDescendants<false> Json::Descendants()
+{
+  return JsonDescendants<false>(this);
+}
+
+inline JsonDescendants<true> Json::Descendants() const
+{
+  return JsonDescendants<true>(this);
+}
+
+inline bool Json::IsLeaf(const Json& node)
+{
+  auto children = std::get_if<ChildrenList>(&node.value_);
+  return children == nullptr || children->empty();
+}
+
+inline auto Json::Leaves()
+{
+  return Descendants() | std::views::filter([](const Json& node) { return IsLeaf(node); });
+}
+
+inline auto Json::Leaves() const
+{
+  return Descendants() | std::views::filter([](const Json& node) { return IsLeaf(node); });
+}
+
+
+template<Predicate T>
+Json* Json::FindIf(const T& predicate)
+{
+  std::vector<Json*> pending;
+  return Search(this, predicate, nullptr, pending);
+}
+
+template<Predicate T>
+std::list<Json*> Json::FindAllIf(const T& predicate)
+{
+  std::list<Json*> found;
+  std::vector<Json*> pending{ this };
+
+  // Visiting a node before its children from the last one and prepending the matches yields post-order
+  while (!pending.empty())
+  {
+    auto node = pending.back();
+    pending.pop_back();
+
+    if (predicate(*node)) found.push_front(node);
+
+    if (!std::holds_alternative<ChildrenList>(node->value_)) continue;
+    for (auto& child : std::get<ChildrenList>(node->value_)) pending.push_back(child.get());
+  }
+
+  return found;
+}
+
 template<Predicate T>
-Json* Json::FindIf(const T& predicate) {
-  Json* found = nullptr;
-  auto result = predicate(*this);
-  if (!result) {
+void Json::FindAllIf(const T& predicate, std::vector<Json*>& found)
+{
+  std::vector<Json*> pending;
+
+  found.clear();
+  Search(this, predicate, &found, pending);
+}
 
-    if (std::holds_alternative<ChildrenList>(value_))
+template<Predicate T>
+Json* Json::FindIf(ThreadPool& pool, const T& predicate)
+{
+  return SearchParallel(pool, predicate, nullptr);
+}
+
+template<Predicate T>
+void Json::FindAllIf(ThreadPool& pool, const T& predicate, std::vector<Json*>& found)
+{
+  found.clear();
+  SearchParallel(pool, predicate, &found);
+}
+
+template<Predicate T>
+Json* Json::Search(Json* root, const T& predicate, std::vector<Json*>* found, std::vector<Json*>& pending)
+{
+  pending.clear();
+  pending.push_back(root);
+
+  while (!pending.empty())
+  {
+    auto node = pending.back();
+    pending.pop_back();
+
+    if (predicate(*node))
+    {
+      if (found == nullptr) return node;
+      found->push_back(node);
+    }
+
+    if (!std::holds_alternative<ChildrenList>(node->value_)) continue;
+
+    // Children are pushed in reverse so they are visited in order
+    auto& children = std::get<ChildrenList>(node->value_);
+    for (auto it = children.rbegin(); it != children.rend(); ++it) pending.push_back(it->get());
+  }
+
+  return nullptr;
+}
+
+template<Predicate T>
+Json* Json::SearchParallel(ThreadPool& pool, const T& predicate, std::vector<Json*>* found)
+{
+  std::vector<Json*> pending{ this };
+
+  while (!pending.empty())
+  {
+    auto node = pending.back();
+    pending.pop_back();
+
+    if (predicate(*node))
+    {
+      if (found == nullptr) return node;
+      found->push_back(node);
+    }
+
+    if (!std::holds_alternative<ChildrenList>(node->value_)) continue;
+
+    auto& children = std::get<ChildrenList>(node->value_);
+    if (children.size() < JSON_FIND_PARALLEL_MIN_CHILDREN)
+    {
+      for (auto it = children.rbegin(); it != children.rend(); ++it) pending.push_back(it->get());
+      continue;
+    }
+
+    // The subtrees of a large list are split into ranges, nested lists are searched sequentially
+    auto range_count = std::min(children.size(), pool.GetThreadCount() * JSON_FIND_TASKS_PER_THREAD);
+    auto range_size = (children.size() + range_count - 1) / range_count;
+
+    std::vector<std::vector<Json*>> results(range_count);
+    std::vector<Json*> first_matches(range_count, nullptr);
+    std::atomic<size_t> first_range{ range_count };
+
+    // Only the ranges of this search are waited for, the pool may be busy with other work or be running this call
+    ThreadPool::Group group;
+
+    for (size_t range = 0; range < range_count; range++)
+    {
+      pool.Submit(group, [&, range]() {
+        std::vector<Json*> stack;
+        auto last = std::min(children.size(), (range + 1) * range_size);
+
+        for (auto i = range * range_size; i < last; i++)
+        {
+          // A match in an earlier range comes first in document order
+          if (found == nullptr && first_range.load(std::memory_order_relaxed) < range) return;
+
+          auto match = Search(children[i].get(), predicate, found == nullptr ? nullptr : &results[range], stack);
+          if (match == nullptr) continue;
+
+          first_matches[range] = match;
+          auto current = first_range.load(std::memory_order_relaxed);
+          while (range < current && !first_range.compare_exchange_weak(current, range, std::memory_order_relaxed)) {}
+          return;
+        }
+        });
+    }
+
+    pool.Wait(group);
+
+    // The subtree precedes every node still pending
+    if (found == nullptr)
     {
-      auto& children = std::get<ChildrenList>(value_);
-      for (auto& element : children)
+      for (auto match : first_matches)
       {
-        found = element->FindIf(predicate);
+        if (match != nullptr) return match;
       }
+      continue;
     }
 
+    for (auto& result : results) found->insert(found->end(), result.begin(), result.end());
   }
-  else {
-    found = this;
-  }
-  return found;
+
+  return nullptr;
 }
 
 #endif // !JSON_H
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "json_arena.h"
+
+JsonArena::JsonArena(size_t chunk_size)
+  : current_{ nullptr }
+  , end_{ nullptr }
+  , chunk_size_{ std::max<size_t>(chunk_size, 64) }
+  , allocated_bytes_{ 0 }
+  , reserved_bytes_{ 0 }
+{
+}
+
+size_t JsonArena::GetAllocatedBytes() const
+{
+  return allocated_bytes_;
+}
+
+size_t JsonArena::GetReservedBytes() const
+{
+  return reserved_bytes_;
+}
+
+size_t JsonArena::GetChunkCount() const
+{
+  return chunks_.size();
+}
+
+void JsonArena::Adopt(std::unique_ptr<JsonArena> arena)
+{
+  adopted_.push_back(std::move(arena));
+}
+
+void* JsonArena::do_allocate(size_t bytes, size_t alignment)
+{
+  auto address = reinterpret_cast<std::uintptr_t>(current_);
+  auto aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+
+  if (current_ == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_))
+  {
+    AddChunk(bytes + alignment);
+    address = reinterpret_cast<std::uintptr_t>(current_);
+    aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+  }
+
+  current_ = reinterpret_cast<std::byte*>(aligned + bytes);
+  allocated_bytes_ += bytes;
+
+  return reinterpret_cast<void*>(aligned);
+}
+
+void JsonArena::do_deallocate(void*, size_t, size_t)
+{
+  // Memory is released together with the arena
+}
+
+bool JsonArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+  return this == &other;
+}
+
+void JsonArena::AddChunk(size_t min_size)
+{
+  auto size = std::max(chunk_size_, min_size);
+
+  chunks_.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+  current_ = chunks_.back().get();
+  end_ = current_ + size;
+  reserved_bytes_ += size;
+
+  // Grow geometrically so large documents end up with few chunks
+  chunk_size_ = std::min<size_t>(chunk_size_ * 2, JSON_ARENA_MAX_CHUNK_SIZE);
+}
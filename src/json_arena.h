@@ -0,0 +1,47 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#define JSON_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define JSON_ARENA_MAX_CHUNK_SIZE (16 * 1024 * 1024)
+
+/*
+ * Bump allocator backing arena documents. Memory is carved out of large
+ * chunks, deallocation is a no-op and everything is released at once when
+ * the arena is destroyed.
+ */
+class JsonArena : public std::pmr::memory_resource {
+public:
+  explicit JsonArena(size_t chunk_size = JSON_ARENA_DEFAULT_CHUNK_SIZE);
+  JsonArena(const JsonArena&) = delete;
+  JsonArena& operator=(const JsonArena&) = delete;
+  ~JsonArena() override = default;
+
+  size_t GetAllocatedBytes() const;
+  size_t GetReservedBytes() const;
+  size_t GetChunkCount() const;
+
+  /* Keeps another arena alive for as long as this one, used to merge documents built in parallel */
+  void Adopt(std::unique_ptr<JsonArena> arena);
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  void AddChunk(size_t min_size);
+
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  std::byte* current_;
+  std::byte* end_;
+  size_t chunk_size_;
+  size_t allocated_bytes_;
+  size_t reserved_bytes_;
+  std::vector<std::unique_ptr<JsonArena>> adopted_;
+};
+
+#endif // !JSON_ARENA_H
@@ -0,0 +1,411 @@
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "json_compact.h"
+
+JsonCompact::JsonCompact()
+{
+}
+
+JsonCompact::Element JsonCompact::GetRoot() const
+{
+  if (!IsValid()) return Element();
+  return Element(this, 0);
+}
+
+bool JsonCompact::IsValid() const
+{
+  return !nodes_.empty();
+}
+
+size_t JsonCompact::GetNodeCount() const
+{
+  return nodes_.size();
+}
+
+std::string JsonCompact::ToString(const SerializeOptions& options) const
+{
+  return GetRoot().ToString(options);
+}
+
+std::unique_ptr<JsonCompact> JsonCompact::Parse(std::string_view data)
+{
+  auto document = std::make_unique<JsonCompact>();
+  JsonCompactBuilder builder(*document);
+  JsonSaxParser<JsonCompactBuilder> parser(builder);
+
+  if (!parser.Parse(data)) document->Clear();
+  return document;
+}
+
+std::string_view JsonCompact::GetEntry(const std::string& buffer, uint64_t offset)
+{
+  uint32_t size;
+  std::memcpy(&size, buffer.data() + offset, sizeof(size));
+
+  return std::string_view(buffer.data() + offset + sizeof(size), size);
+}
+
+uint64_t JsonCompact::AppendEntry(std::string& buffer, std::string_view str)
+{
+  auto offset = buffer.size();
+  auto size = static_cast<uint32_t>(str.size());
+
+  buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  buffer.append(str);
+
+  return offset;
+}
+
+uint32_t JsonCompact::AddKey(std::string_view key)
+{
+  auto it = key_offsets_.find(key);
+  if (it != key_offsets_.end()) return it->second;
+
+  // Offsets of keys are 32-bit, no_key is reserved
+  if (key.size() > std::numeric_limits<uint32_t>::max() || keys_.size() + key.size() >= no_key - sizeof(uint32_t)) return no_key;
+
+  auto offset = static_cast<uint32_t>(AppendEntry(keys_, key));
+  key_offsets_.emplace(key, offset);
+
+  return offset;
+}
+
+uint64_t JsonCompact::AddString(std::string_view str)
+{
+  return AppendEntry(strings_, str);
+}
+
+bool JsonCompact::AppendBlock(const std::vector<Node>& block, uint64_t& payload)
+{
+  if (nodes_.size() + block.size() > std::numeric_limits<uint32_t>::max()) return false;
+
+  payload = (static_cast<uint64_t>(block.size()) << 32) | static_cast<uint32_t>(nodes_.size());
+  nodes_.insert(nodes_.end(), block.begin(), block.end());
+
+  return true;
+}
+
+void JsonCompact::Clear()
+{
+  nodes_.clear();
+  keys_.clear();
+  strings_.clear();
+  key_offsets_.clear();
+}
+
+
+JsonCompact::Element::Element()
+  : document_{ nullptr }
+  , index_{ 0 }
+{
+}
+
+JsonCompact::Element::Element(const JsonCompact* document, uint32_t index)
+  : document_{ document }
+  , index_{ index }
+{
+}
+
+Json::ValueType JsonCompact::Element::GetType() const
+{
+  if (!IsValid()) return Json::ValueType::Undefined;
+
+  switch (GetNode().tag)
+  {
+  case Tag::Object:       return Json::ValueType::Object;
+  case Tag::Array:        return Json::ValueType::Array;
+  case Tag::String:       return Json::ValueType::String;
+  case Tag::Double:
+  case Tag::Int64:
+  case Tag::UInt64:       return Json::ValueType::Number;
+  case Tag::True:
+  case Tag::False:        return Json::ValueType::Bool;
+  case Tag::Null:         return Json::ValueType::Null;
+  default:                return Json::ValueType::Undefined;
+  }
+}
+
+std::string_view JsonCompact::Element::GetKey() const
+{
+  if (!IsValid() || GetNode().key == no_key) return std::string_view();
+  return GetEntry(document_->keys_, GetNode().key);
+}
+
+std::string_view JsonCompact::Element::GetString() const
+{
+  if (GetType() != Json::ValueType::String) return std::string_view();
+  return GetEntry(document_->strings_, GetNode().payload);
+}
+
+Number JsonCompact::Element::GetNumber() const
+{
+  if (GetType() != Json::ValueType::Number) return Number();
+
+  auto raw = GetNode().payload;
+  switch (GetNode().tag)
+  {
+  case Tag::Int64:        return static_cast<Number>(std::bit_cast<Integer>(raw));
+  case Tag::UInt64:       return static_cast<Number>(raw);
+  default:                return std::bit_cast<Number>(raw);
+  }
+}
+
+Integer JsonCompact::Element::GetInt64() const
+{
+  if (GetType() != Json::ValueType::Number) return Integer();
+
+  auto raw = GetNode().payload;
+  switch (GetNode().tag)
+  {
+  case Tag::Int64:        return std::bit_cast<Integer>(raw);
+  case Tag::UInt64:       return static_cast<Integer>(raw);
+  default:                return static_cast<Integer>(std::bit_cast<Number>(raw));
+  }
+}
+
+Unsigned JsonCompact::Element::GetUInt64() const
+{
+  if (GetType() != Json::ValueType::Number) return Unsigned();
+
+  auto raw = GetNode().payload;
+  switch (GetNode().tag)
+  {
+  case Tag::Int64:        return static_cast<Unsigned>(std::bit_cast<Integer>(raw));
+  case Tag::UInt64:       return raw;
+  default:                return static_cast<Unsigned>(std::bit_cast<Number>(raw));
+  }
+}
+
+bool JsonCompact::Element::IsInteger() const
+{
+  return IsValid() && (GetNode().tag == Tag::Int64 || GetNode().tag == Tag::UInt64);
+}
+
+Bool JsonCompact::Element::GetBool() const
+{
+  return IsValid() && GetNode().tag == Tag::True;
+}
+
+size_t JsonCompact::Element::Size() const
+{
+  auto type = GetType();
+  if (type != Json::ValueType::Object && type != Json::ValueType::Array) return 0;
+
+  return static_cast<size_t>(GetNode().payload >> 32);
+}
+
+bool JsonCompact::Element::IsValid() const
+{
+  return document_ != nullptr && index_ < document_->nodes_.size();
+}
+
+bool JsonCompact::Element::IsArrayElement() const
+{
+  return IsValid() && GetNode().key == no_key && index_ != 0;
+}
+
+JsonCompact::Element JsonCompact::Element::operator[](std::string_view key) const
+{
+  if (GetType() != Json::ValueType::Object) return Element();
+
+  // A key missing from the document cannot be a member of any object
+  auto it = document_->key_offsets_.find(key);
+  if (it == document_->key_offsets_.end()) return Element();
+
+  auto first = static_cast<uint32_t>(GetNode().payload);
+  auto end = first + static_cast<uint32_t>(GetNode().payload >> 32);
+
+  for (auto index = first; index < end; index++)
+  {
+    if (document_->nodes_[index].key == it->second) return Element(document_, index);
+  }
+
+  return Element();
+}
+
+JsonCompact::Element JsonCompact::Element::operator[](int index) const
+{
+  if (index < 0 || static_cast<size_t>(index) >= Size()) return Element();
+
+  return Element(document_, static_cast<uint32_t>(GetNode().payload) + index);
+}
+
+std::string JsonCompact::Element::ToString(const SerializeOptions& options) const
+{
+  std::string json_string;
+
+  if (IsValid())
+  {
+    JsonSerializer serializer(json_string, options);
+    Serialize(serializer);
+    serializer.Finish();
+  }
+
+  return json_string;
+}
+
+const JsonCompact::Node& JsonCompact::Element::GetNode() const
+{
+  return document_->nodes_[index_];
+}
+
+void JsonCompact::Element::Serialize(JsonSerializer& serializer) const
+{
+  if (GetNode().key != no_key) serializer.WriteKey(GetKey());
+
+  switch (GetNode().tag)
+  {
+  case Tag::Object:
+  case Tag::Array:
+  {
+    bool is_object = GetNode().tag == Tag::Object;
+    is_object ? serializer.StartObject() : serializer.StartArray();
+
+    ForEachChild([&serializer](const Element& child) -> void {
+      child.Serialize(serializer);
+      });
+
+    is_object ? serializer.EndObject() : serializer.EndArray();
+  }
+    break;
+
+  case Tag::String:
+    serializer.WriteString(GetString());
+    break;
+
+  case Tag::Double:
+    serializer.WriteNumber(GetNumber());
+    break;
+
+  case Tag::Int64:
+    serializer.WriteNumber(GetInt64());
+    break;
+
+  case Tag::UInt64:
+    serializer.WriteNumber(GetUInt64());
+    break;
+
+  case Tag::True:
+  case Tag::False:
+    serializer.WriteBool(GetBool());
+    break;
+
+  case Tag::Null:
+    serializer.WriteNull();
+    break;
+
+  default:
+    break;
+  }
+}
+
+
+JsonCompactBuilder::JsonCompactBuilder(JsonCompact& document)
+  : document_{ document }
+  , key_{ JsonCompact::no_key }
+{
+  // The root node is filled in once the root value is complete
+  document_.Clear();
+  document_.nodes_.push_back(JsonCompact::Node{ JsonCompact::no_key, JsonCompact::Tag::Null, 0 });
+}
+
+bool JsonCompactBuilder::OnStartObject()
+{
+  return StartContainer(JsonCompact::Tag::Object);
+}
+
+bool JsonCompactBuilder::OnEndObject(size_t /*count*/)
+{
+  return EndContainer();
+}
+
+bool JsonCompactBuilder::OnStartArray()
+{
+  return StartContainer(JsonCompact::Tag::Array);
+}
+
+bool JsonCompactBuilder::OnEndArray(size_t /*count*/)
+{
+  return EndContainer();
+}
+
+bool JsonCompactBuilder::OnKey(std::string_view key)
+{
+  key_ = document_.AddKey(key);
+  return key_ != JsonCompact::no_key;
+}
+
+bool JsonCompactBuilder::OnString(std::string_view value)
+{
+  if (value.size() > std::numeric_limits<uint32_t>::max()) return false;
+  return AddValue(JsonCompact::Tag::String, document_.AddString(value));
+}
+
+bool JsonCompactBuilder::OnNumber(Number value)
+{
+  return AddValue(JsonCompact::Tag::Double, std::bit_cast<uint64_t>(value));
+}
+
+bool JsonCompactBuilder::OnInt64(Integer value)
+{
+  return AddValue(JsonCompact::Tag::Int64, std::bit_cast<uint64_t>(value));
+}
+
+bool JsonCompactBuilder::OnUInt64(Unsigned value)
+{
+  return AddValue(JsonCompact::Tag::UInt64, value);
+}
+
+bool JsonCompactBuilder::OnBool(Bool value)
+{
+  return AddValue(value ? JsonCompact::Tag::True : JsonCompact::Tag::False, 0);
+}
+
+bool JsonCompactBuilder::OnNull()
+{
+  return AddValue(JsonCompact::Tag::Null, 0);
+}
+
+bool JsonCompactBuilder::StartContainer(JsonCompact::Tag tag)
+{
+  bool in_object = !open_.empty() && open_.back().tag == JsonCompact::Tag::Object;
+  open_.push_back(JsonCompact::Node{ in_object ? key_ : JsonCompact::no_key, tag, 0 });
+
+  if (levels_.size() < open_.size()) levels_.emplace_back();
+  levels_[open_.size() - 1].clear();
+
+  return true;
+}
+
+bool JsonCompactBuilder::EndContainer()
+{
+  auto node = open_.back();
+  if (!document_.AppendBlock(levels_[open_.size() - 1], node.payload)) return false;
+
+  open_.pop_back();
+
+  if (open_.empty())
+  {
+    document_.nodes_[0] = node;
+    return true;
+  }
+
+  levels_[open_.size() - 1].push_back(node);
+  return true;
+}
+
+bool JsonCompactBuilder::AddValue(JsonCompact::Tag tag, uint64_t payload)
+{
+  if (open_.empty())
+  {
+    document_.nodes_[0] = JsonCompact::Node{ JsonCompact::no_key, tag, payload };
+    return true;
+  }
+
+  bool in_object = open_.back().tag == JsonCompact::Tag::Object;
+  levels_[open_.size() - 1].push_back(JsonCompact::Node{ in_object ? key_ : JsonCompact::no_key, tag, payload });
+
+  return true;
+}
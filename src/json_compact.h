@@ -0,0 +1,202 @@
+#ifndef JSON_COMPACT_H
+#define JSON_COMPACT_H
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "json.h"
+#include "json_sax.h"
+#include "json_serializer.h"
+
+/*
+ * Read-only document made of 16 byte nodes stored by value in one array.
+ *
+ * The children of a container are a contiguous block of nodes, the container
+ * keeps the index of the first one and their count. Numbers and literals are
+ * inline in the node, keys and strings are offsets into two byte buffers with
+ * a 32-bit length in front of every entry. Every distinct key is stored once,
+ * so member lookup compares key offsets instead of strings.
+ *
+ * The root is always the first node, blocks follow in the order their
+ * containers were closed.
+ */
+class JsonCompact {
+public:
+  enum class Tag : uint8_t {
+    Object = '{',
+    Array = '[',
+    String = '"',
+    Double = 'd',
+    Int64 = 'l',
+    UInt64 = 'u',
+    True = 't',
+    False = 'f',
+    Null = 'n',
+  };
+
+  struct Node {
+    uint32_t key;       // offset in the key buffer, no_key for the root and array elements
+    Tag tag;
+    uint64_t payload;   // inline value, string offset or (count << 32 | first child)
+  };
+
+  static_assert(sizeof(Node) == 16, "JsonCompact::Node must stay within 16 bytes");
+
+  class Element {
+  public:
+    Element();
+    Element(const JsonCompact* document, uint32_t index);
+
+    Json::ValueType GetType() const;
+    std::string_view GetKey() const;
+    std::string_view GetString() const;
+    Number GetNumber() const;
+    Integer GetInt64() const;
+    Unsigned GetUInt64() const;
+    Bool GetBool() const;
+    size_t Size() const;
+
+    bool IsValid() const;
+    bool IsArrayElement() const;
+    bool IsInteger() const;
+
+    Element operator[](std::string_view key) const;
+    Element operator[](int index) const;
+
+    template<class T> requires std::invocable<T&, const Element&>
+    void ForEachChild(T&& visitor) const;
+
+    /* Json conversion to string */
+    std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  private:
+    const Node& GetNode() const;
+    void Serialize(JsonSerializer& serializer) const;
+
+    const JsonCompact* document_;
+    uint32_t index_;
+
+    friend class JsonCompact;
+  };
+
+  JsonCompact();
+
+  Element GetRoot() const;
+  bool IsValid() const;
+  size_t GetNodeCount() const;
+
+  /* Json conversion to string */
+  std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  /* Elements matching the predicate in document order, walked without recursion */
+  template<class T> requires std::predicate<const T&, const Element&>
+  std::vector<Element> FindAllIf(const T& predicate) const;
+
+  /* Parsing methods */
+  static std::unique_ptr<JsonCompact> Parse(std::string_view data);
+
+private:
+  static constexpr uint32_t no_key = static_cast<uint32_t>(-1);
+
+  struct KeyHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+  };
+
+  static std::string_view GetEntry(const std::string& buffer, uint64_t offset);
+  static uint64_t AppendEntry(std::string& buffer, std::string_view str);
+
+  /* Building methods, used by JsonCompactBuilder */
+  uint32_t AddKey(std::string_view key);
+  uint64_t AddString(std::string_view str);
+  bool AppendBlock(const std::vector<Node>& block, uint64_t& payload);
+  void Clear();
+
+  std::vector<Node> nodes_;
+  std::string keys_;
+  std::string strings_;
+  std::unordered_map<std::string, uint32_t, KeyHash, std::equal_to<>> key_offsets_;
+
+  friend class JsonCompactBuilder;
+};
+
+/*
+ * SAX handler collecting the children of every open container in a block per
+ * depth; a closed container moves its block to the document in one piece.
+ */
+class JsonCompactBuilder : public JsonSaxHandler {
+public:
+  explicit JsonCompactBuilder(JsonCompact& document);
+
+  bool OnStartObject();
+  bool OnEndObject(size_t count);
+  bool OnStartArray();
+  bool OnEndArray(size_t count);
+  bool OnKey(std::string_view key);
+  bool OnString(std::string_view value);
+  bool OnNumber(Number value);
+  bool OnInt64(Integer value);
+  bool OnUInt64(Unsigned value);
+  bool OnBool(Bool value);
+  bool OnNull();
+
+private:
+  bool StartContainer(JsonCompact::Tag tag);
+  bool EndContainer();
+  bool AddValue(JsonCompact::Tag tag, uint64_t payload);
+
+  JsonCompact& document_;
+
+  /* Open containers and the blocks of their children, levels are reused */
+  std::vector<JsonCompact::Node> open_;
+  std::vector<std::vector<JsonCompact::Node>> levels_;
+  uint32_t key_;
+};
+
+
+template<class T> requires std::invocable<T&, const JsonCompact::Element&>
+void JsonCompact::Element::ForEachChild(T&& visitor) const
+{
+  auto count = static_cast<uint32_t>(Size());
+  if (count == 0) return;
+
+  auto first = static_cast<uint32_t>(GetNode().payload);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    visitor(Element(document_, first + i));
+  }
+}
+
+template<class T> requires std::predicate<const T&, const JsonCompact::Element&>
+std::vector<JsonCompact::Element> JsonCompact::FindAllIf(const T& predicate) const
+{
+  std::vector<Element> found;
+  if (!IsValid()) return found;
+
+  // Children are pushed in reverse so they are visited in order
+  std::vector<uint32_t> pending{ 0 };
+
+  while (!pending.empty())
+  {
+    Element element(this, pending.back());
+    pending.pop_back();
+
+    if (predicate(element)) found.push_back(element);
+
+    auto& node = element.GetNode();
+    if (node.tag != Tag::Object && node.tag != Tag::Array) continue;
+
+    auto first = static_cast<uint32_t>(node.payload);
+    for (auto i = static_cast<uint32_t>(node.payload >> 32); i > 0; i--) pending.push_back(first + i - 1);
+  }
+
+  return found;
+}
+
+#endif // !JSON_COMPACT_H
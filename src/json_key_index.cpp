@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+#include "json_key_index.h"
+#include "json.h"
+
+JsonKeyIndex::JsonKeyIndex(std::pmr::memory_resource* resource)
+  : slots_{ resource }
+  , used_{ 0 }
+  , tombstones_{ 0 }
+  , members_{ 0 }
+  , has_duplicates_{ false }
+{
+}
+
+JsonKeyIndex* JsonKeyIndex::Create(std::pmr::memory_resource* resource)
+{
+  std::pmr::polymorphic_allocator<JsonKeyIndex> allocator(resource);
+  return allocator.new_object<JsonKeyIndex>(resource);
+}
+
+void JsonKeyIndex::Destroy(JsonKeyIndex* index)
+{
+  if (index == nullptr) return;
+
+  std::pmr::polymorphic_allocator<JsonKeyIndex> allocator(index->slots_.get_allocator());
+  allocator.delete_object(index);
+}
+
+void JsonKeyIndex::Build(const Json& object)
+{
+  auto& children = std::get<ChildrenList>(object.value_);
+
+  members_ = 0;
+  has_duplicates_ = false;
+  Rehash(std::bit_ceil(std::max<size_t>(children.size() * 2, JSON_KEY_INDEX_MIN_SIZE)));
+
+  for (auto& child : children) Insert(child.get());
+}
+
+Json* JsonKeyIndex::Find(std::string_view key, const std::string* interned) const
+{
+  if (slots_.empty()) return nullptr;
+
+  auto mask = slots_.size() - 1;
+
+  for (auto i = Hash(key) & mask; slots_[i] != nullptr; i = (i + 1) & mask)
+  {
+    if (slots_[i] != Tombstone() && slots_[i]->HasKey(key, interned)) return slots_[i];
+  }
+
+  return nullptr;
+}
+
+void JsonKeyIndex::Insert(Json* member)
+{
+  members_++;
+
+  // Keep the table at most half full, tombstones included
+  if ((used_ + tombstones_ + 1) * 2 > slots_.size())
+  {
+    auto capacity = std::max<size_t>(slots_.size(), JSON_KEY_INDEX_MIN_SIZE);
+    Rehash((used_ + 1) * 4 > capacity ? capacity * 2 : capacity);
+  }
+
+  std::string_view key = member->GetKey();
+  auto mask = slots_.size() - 1;
+  auto free_slot = slots_.size();
+  auto i = Hash(key) & mask;
+
+  for (; slots_[i] != nullptr; i = (i + 1) & mask)
+  {
+    if (slots_[i] == Tombstone())
+    {
+      if (free_slot == slots_.size()) free_slot = i;
+    }
+    else if (slots_[i]->GetKey() == key)
+    {
+      // The first member with a key wins, later ones are only counted
+      has_duplicates_ = true;
+      return;
+    }
+  }
+
+  if (free_slot == slots_.size()) free_slot = i;
+  else tombstones_--;
+
+  slots_[free_slot] = member;
+  used_++;
+}
+
+void JsonKeyIndex::Erase(Json* member)
+{
+  members_--;
+
+  if (slots_.empty()) return;
+
+  auto mask = slots_.size() - 1;
+
+  for (auto i = Hash(member->GetKey()) & mask; slots_[i] != nullptr; i = (i + 1) & mask)
+  {
+    if (slots_[i] == member)
+    {
+      slots_[i] = Tombstone();
+      used_--;
+      tombstones_++;
+      return;
+    }
+  }
+}
+
+size_t JsonKeyIndex::GetMemberCount() const
+{
+  return members_;
+}
+
+bool JsonKeyIndex::HasDuplicates() const
+{
+  return has_duplicates_;
+}
+
+size_t JsonKeyIndex::Hash(std::string_view key)
+{
+  return std::hash<std::string_view>{}(key);
+}
+
+Json* JsonKeyIndex::Tombstone()
+{
+  static char marker;
+  return reinterpret_cast<Json*>(&marker);
+}
+
+void JsonKeyIndex::Rehash(size_t capacity)
+{
+  std::pmr::vector<Json*> old_slots(capacity, nullptr, slots_.get_allocator());
+  old_slots.swap(slots_);
+
+  used_ = 0;
+  tombstones_ = 0;
+
+  for (auto member : old_slots)
+  {
+    if (member != nullptr && member != Tombstone()) Place(member, Hash(member->GetKey()));
+  }
+}
+
+void JsonKeyIndex::Place(Json* member, size_t hash)
+{
+  auto mask = slots_.size() - 1;
+  auto i = hash & mask;
+
+  while (slots_[i] != nullptr) i = (i + 1) & mask;
+
+  slots_[i] = member;
+  used_++;
+}
@@ -0,0 +1,54 @@
+#ifndef JSON_KEY_INDEX_H
+#define JSON_KEY_INDEX_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Objects with fewer members are searched linearly, the scan beats hashing there */
+#define JSON_KEY_INDEX_MIN_SIZE 16
+
+class Json;
+
+/*
+ * Open addressing hash table from member key to member node, attached lazily
+ * to large objects. It stores node pointers only, the children list keeps
+ * the insertion order used for serialization. When keys repeat only the first
+ * member is indexed, matching the linear lookup.
+ */
+class JsonKeyIndex {
+public:
+  explicit JsonKeyIndex(std::pmr::memory_resource* resource);
+  JsonKeyIndex(const JsonKeyIndex&) = delete;
+  JsonKeyIndex& operator=(const JsonKeyIndex&) = delete;
+
+  /* Index and its table are allocated from the node's memory resource */
+  static JsonKeyIndex* Create(std::pmr::memory_resource* resource);
+  static void Destroy(JsonKeyIndex* index);
+
+  void Build(const Json& object);
+  Json* Find(std::string_view key, const std::string* interned = nullptr) const;
+  void Insert(Json* member);
+  void Erase(Json* member);
+
+  /* Number of members the index accounts for, duplicates included */
+  size_t GetMemberCount() const;
+  bool HasDuplicates() const;
+
+private:
+  static size_t Hash(std::string_view key);
+  static Json* Tombstone();
+
+  void Rehash(size_t capacity);
+  void Place(Json* member, size_t hash);
+
+  std::pmr::vector<Json*> slots_;
+  size_t used_;
+  size_t tombstones_;
+  size_t members_;
+  bool has_duplicates_;
+};
+
+#endif // !JSON_KEY_INDEX_H
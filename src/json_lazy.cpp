@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <variant>
+
+#include "json_lazy.h"
+#include "json_parser.h"
+#include "json_reader.h"
+#include "json_sax.h"
+#include "number_parser.h"
+#include "string_scanner.h"
+
+namespace {
+
+  /* Characters that change the depth while a container is skipped, strings are skipped as a whole */
+  constexpr std::array<bool, 256> skip_stops = []() {
+    std::array<bool, 256> table{};
+
+    for (auto ch : { '\"', '{', '}', '[', ']' }) table[static_cast<uint8_t>(ch)] = true;
+
+    return table;
+  }();
+
+  /* Handler for validation only, strings are checked but not decoded */
+  class JsonValidator : public JsonSaxHandler {
+  public:
+    bool OnRawKey(std::string_view /*raw*/, bool /*escaped*/) { return true; }
+    bool OnRawString(std::string_view /*raw*/, bool /*escaped*/) { return true; }
+  };
+
+  /* Converted number, zero when the element is not one */
+  template<class T>
+  T ConvertNumber(std::string_view raw)
+  {
+    NumberValue value;
+    if (NumberParser::Parse(raw.data(), raw.data() + raw.size(), value) == nullptr) return T();
+
+    return std::visit([](auto number) { return static_cast<T>(number); }, value);
+  }
+
+  /* Subtrees may be scalars, which Json::Parse does not take as the root */
+  std::unique_ptr<Json> Build(std::string_view raw, const ParseOptions& options)
+  {
+    JsonParser parser;
+    return parser.ParseValue(raw, options);
+  }
+
+}
+
+JsonLazy::JsonLazy()
+  : root_begin_{ 0 }
+  , root_end_{ 0 }
+{
+}
+
+JsonLazy::Element JsonLazy::GetRoot() const
+{
+  if (!IsValid()) return Element();
+  return Element(this, root_begin_, root_end_);
+}
+
+bool JsonLazy::IsValid() const
+{
+  return root_end_ > root_begin_;
+}
+
+size_t JsonLazy::GetIndexedCount() const
+{
+  return containers_.size();
+}
+
+size_t JsonLazy::GetMaterializedCount() const
+{
+  return materialized_.size();
+}
+
+std::string JsonLazy::ToString(const SerializeOptions& options) const
+{
+  return GetRoot().ToString(options);
+}
+
+std::unique_ptr<JsonLazy> JsonLazy::Parse(std::string_view data, const ParseOptions& options)
+{
+  auto document = std::make_unique<JsonLazy>();
+
+  document->options_ = options;
+  if (!document->Load(data)) document->Clear();
+
+  return document;
+}
+
+std::unique_ptr<JsonLazy> JsonLazy::Parse(const char* data, const ParseOptions& options)
+{
+  return Parse(std::string_view(data), options);
+}
+
+std::unique_ptr<JsonLazy> JsonLazy::Parse(std::string&& data, const ParseOptions& options)
+{
+  auto document = std::make_unique<JsonLazy>();
+
+  document->options_ = options;
+  document->input_ = std::move(data);
+  if (!document->Load(document->input_)) document->Clear();
+
+  return document;
+}
+
+std::unique_ptr<JsonLazy> JsonLazy::ParseTrusted(std::string_view data)
+{
+  auto document = std::make_unique<JsonLazy>();
+  if (!document->Load(data, false)) document->Clear();
+
+  return document;
+}
+
+bool JsonLazy::Load(std::string_view data, bool validate)
+{
+  if (options_.max_input_size != 0 && data.size() > options_.max_input_size) return false;
+
+  // Validation builds nothing, it only rejects what the scanning helpers would misread
+  if (validate)
+  {
+    JsonValidator validator;
+    JsonSaxParser<JsonValidator> parser(validator, options_.max_depth);
+
+    if (!parser.Parse(data)) return false;
+  }
+
+  data_ = data;
+  root_begin_ = SkipWhitespace(data.data()) - data.data();
+  root_end_ = data.size();
+
+  while (root_end_ > root_begin_ && JsonReader::IsWhitespace(data[root_end_ - 1])) root_end_--;
+
+  return root_end_ > root_begin_;
+}
+
+void JsonLazy::Clear()
+{
+  input_.clear();
+  data_ = std::string_view();
+  root_begin_ = 0;
+  root_end_ = 0;
+
+  containers_.clear();
+  materialized_.clear();
+  decoded_strings_.clear();
+}
+
+JsonLazy::Container& JsonLazy::GetContainer(size_t begin) const
+{
+  return containers_.try_emplace(begin, Container{ {}, begin + 1, false }).first->second;
+}
+
+bool JsonLazy::ScanMember(Container& container, bool is_object) const
+{
+  if (container.complete) return false;
+
+  auto end = data_.data() + data_.size();
+  auto ch = SkipWhitespace(data_.data() + container.next);
+  if (ch != end && *ch == ',') ch = SkipWhitespace(ch + 1);
+
+  // The end of the input only comes first in trusted documents that are not valid
+  if (ch == end || *ch == '}' || *ch == ']')
+  {
+    container.complete = true;
+    return false;
+  }
+
+  Member member{ std::string_view(), false, 0, 0 };
+
+  if (is_object)
+  {
+    auto key_end = SkipString(ch);
+    member.key = std::string_view(ch + 1, std::max<ptrdiff_t>(key_end - ch - 2, 0));
+    member.key_escaped = member.key.find('\\') != std::string_view::npos;
+
+    // Colon between the key and the value
+    auto colon = SkipWhitespace(key_end);
+    ch = colon == end ? end : SkipWhitespace(colon + 1);
+
+    if (ch == end)
+    {
+      container.complete = true;
+      return false;
+    }
+  }
+
+  member.begin = ch - data_.data();
+  member.end = SkipValue(ch) - data_.data();
+
+  container.next = member.end;
+  container.members.push_back(member);
+
+  return true;
+}
+
+std::string_view JsonLazy::Decode(std::string_view raw) const
+{
+  auto it = decoded_strings_.find(raw.data());
+  if (it != decoded_strings_.end()) return it->second;
+
+  auto& decoded = decoded_strings_[raw.data()];
+  StringScanner::Unescape(raw, decoded);
+
+  return decoded;
+}
+
+const char* JsonLazy::SkipWhitespace(const char* ch) const
+{
+  auto end = data_.data() + data_.size();
+  while (ch != end && JsonReader::IsWhitespace(*ch)) ch++;
+
+  return ch;
+}
+
+const char* JsonLazy::SkipString(const char* ch) const
+{
+  auto end = data_.data() + data_.size();
+  ch++;
+
+  // Only quotes and backslashes can stop the scanner in a valid string
+  while (true)
+  {
+    ch = StringScanner::FindSpecial(ch, end);
+    if (ch == end) return end;
+    if (*ch == '\"') return ch + 1;
+    if (end - ch < 2) return end;
+
+    ch += 2;
+  }
+}
+
+const char* JsonLazy::SkipValue(const char* ch) const
+{
+  if (*ch == '\"') return SkipString(ch);
+
+  auto end = data_.data() + data_.size();
+
+  if (*ch != '{' && *ch != '[')
+  {
+    while (ch != end && !JsonReader::IsWhitespace(*ch) && *ch != ',' && *ch != '}' && *ch != ']') ch++;
+    return ch;
+  }
+
+  // Brackets inside of strings do not count
+  size_t depth = 0;
+
+  do
+  {
+    while (ch != end && !skip_stops[static_cast<uint8_t>(*ch)]) ch++;
+    if (ch == end) break;
+
+    switch (*ch)
+    {
+    case '\"':
+      ch = SkipString(ch);
+      continue;
+
+    case '{':
+    case '[':
+      depth++;
+      break;
+
+    default:
+      depth--;
+      break;
+    }
+
+    ch++;
+  } while (depth > 0);
+
+  return ch;
+}
+
+
+JsonLazy::Element::Element()
+  : document_{ nullptr }
+  , begin_{ 0 }
+  , end_{ 0 }
+  , key_escaped_{ false }
+{
+}
+
+JsonLazy::Element::Element(const JsonLazy* document, size_t begin, size_t end, std::string_view key, bool key_escaped)
+  : document_{ document }
+  , begin_{ begin }
+  , end_{ end }
+  , key_{ key }
+  , key_escaped_{ key_escaped }
+{
+}
+
+Json::ValueType JsonLazy::Element::GetType() const
+{
+  if (!IsValid()) return Json::ValueType::Undefined;
+
+  switch (document_->data_[begin_])
+  {
+  case '{':   return Json::ValueType::Object;
+  case '[':   return Json::ValueType::Array;
+  case '\"':  return Json::ValueType::String;
+  case 't':
+  case 'f':   return Json::ValueType::Bool;
+  case 'n':   return Json::ValueType::Null;
+  default:    return Json::ValueType::Number;
+  }
+}
+
+std::string_view JsonLazy::Element::GetKey() const
+{
+  return key_escaped_ ? document_->Decode(key_) : key_;
+}
+
+std::string_view JsonLazy::Element::GetString() const
+{
+  if (GetType() != Json::ValueType::String) return std::string_view();
+
+  auto raw = document_->data_.substr(begin_ + 1, end_ - begin_ - 2);
+  if (raw.find('\\') == std::string_view::npos) return raw;
+
+  return document_->Decode(raw);
+}
+
+Number JsonLazy::Element::GetNumber() const
+{
+  if (GetType() != Json::ValueType::Number) return Number();
+  return ConvertNumber<Number>(GetRaw());
+}
+
+Integer JsonLazy::Element::GetInt64() const
+{
+  if (GetType() != Json::ValueType::Number) return Integer();
+  return ConvertNumber<Integer>(GetRaw());
+}
+
+Unsigned JsonLazy::Element::GetUInt64() const
+{
+  if (GetType() != Json::ValueType::Number) return Unsigned();
+  return ConvertNumber<Unsigned>(GetRaw());
+}
+
+Bool JsonLazy::Element::GetBool() const
+{
+  return IsValid() && document_->data_[begin_] == 't';
+}
+
+size_t JsonLazy::Element::Size() const
+{
+  auto type = GetType();
+  if (type != Json::ValueType::Object && type != Json::ValueType::Array) return 0;
+
+  auto& container = document_->GetContainer(begin_);
+  while (document_->ScanMember(container, type == Json::ValueType::Object)) {}
+
+  return container.members.size();
+}
+
+bool JsonLazy::Element::IsValid() const
+{
+  return document_ != nullptr && end_ > begin_;
+}
+
+bool JsonLazy::Element::IsArrayElement() const
+{
+  return IsValid() && key_.data() == nullptr && begin_ != document_->root_begin_;
+}
+
+bool JsonLazy::Element::IsInteger() const
+{
+  if (GetType() != Json::ValueType::Number) return false;
+
+  NumberValue value;
+  auto raw = GetRaw();
+
+  return NumberParser::Parse(raw.data(), raw.data() + raw.size(), value) != nullptr && !std::holds_alternative<Number>(value);
+}
+
+JsonLazy::Element JsonLazy::Element::operator[](std::string_view key) const
+{
+  if (GetType() != Json::ValueType::Object) return Element();
+
+  auto& container = document_->GetContainer(begin_);
+
+  // Members scanned by earlier lookups are compared first, the rest of the object only when needed
+  size_t i = 0;
+  do
+  {
+    for (; i < container.members.size(); i++)
+    {
+      auto& member = container.members[i];
+      auto member_key = member.key_escaped ? document_->Decode(member.key) : member.key;
+
+      if (member_key == key) return Element(document_, member.begin, member.end, member.key, member.key_escaped);
+    }
+  } while (document_->ScanMember(container, true));
+
+  return Element();
+}
+
+JsonLazy::Element JsonLazy::Element::operator[](int index) const
+{
+  auto type = GetType();
+  if (index < 0 || (type != Json::ValueType::Object && type != Json::ValueType::Array)) return Element();
+
+  auto& container = document_->GetContainer(begin_);
+  while (container.members.size() <= static_cast<size_t>(index))
+  {
+    if (!document_->ScanMember(container, type == Json::ValueType::Object)) return Element();
+  }
+
+  auto& member = container.members[index];
+  return Element(document_, member.begin, member.end, member.key, member.key_escaped);
+}
+
+std::string_view JsonLazy::Element::GetRaw() const
+{
+  if (!IsValid()) return std::string_view();
+  return document_->data_.substr(begin_, end_ - begin_);
+}
+
+const Json* JsonLazy::Element::Materialize() const
+{
+  if (!IsValid()) return nullptr;
+
+  auto& json = document_->materialized_[begin_];
+  if (!json) json = Build(GetRaw(), document_->options_);
+
+  return json.get();
+}
+
+std::string JsonLazy::Element::ToString(const SerializeOptions& options) const
+{
+  if (!IsValid()) return std::string();
+
+  // Subtrees that were not materialized are not kept just for the conversion
+  auto it = document_->materialized_.find(begin_);
+  if (it != document_->materialized_.end()) return it->second->ToString(options);
+
+  return Build(GetRaw(), document_->options_)->ToString(options);
+}
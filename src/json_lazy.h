@@ -0,0 +1,157 @@
+#ifndef JSON_LAZY_H
+#define JSON_LAZY_H
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "json.h"
+
+/*
+ * Document over the input text, validated once and otherwise left as it is.
+ * The validation is a SAX pass over the whole input that builds nothing, it
+ * still reads every byte and takes about a sixth of the time of a DOM parse;
+ * ParseTrusted() skips it. Its depth is bounded by max_depth of the options,
+ * which also limit the subtrees built by Materialize().
+ *
+ * Elements are offsets into the input. Member and element lookups skip the
+ * values in between by scanning for balanced brackets, and remember what they
+ * passed, so every container is scanned at most once and only as far as it
+ * was asked for. Scalars are converted when they are read, Materialize()
+ * builds a Json document for one subtree and keeps it.
+ *
+ * The caches are filled by const methods, a document must not be used from
+ * several threads at once.
+ */
+class JsonLazy {
+public:
+  class Element {
+  public:
+    Element();
+
+    Json::ValueType GetType() const;
+    std::string_view GetKey() const;
+    std::string_view GetString() const;
+    Number GetNumber() const;
+    Integer GetInt64() const;
+    Unsigned GetUInt64() const;
+    Bool GetBool() const;
+    size_t Size() const;
+
+    bool IsValid() const;
+    bool IsArrayElement() const;
+    bool IsInteger() const;
+
+    Element operator[](std::string_view key) const;
+    Element operator[](int index) const;
+
+    template<class T> requires std::invocable<T&, const Element&>
+    void ForEachChild(T&& visitor) const;
+
+    /* Value as it is in the input */
+    std::string_view GetRaw() const;
+
+    /* Subtree built as a Json document on the first call, nullptr for invalid elements */
+    const Json* Materialize() const;
+
+    /* Json conversion to string, without the key of a member */
+    std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  private:
+    Element(const JsonLazy* document, size_t begin, size_t end, std::string_view key = std::string_view(), bool key_escaped = false);
+
+    const JsonLazy* document_;
+    size_t begin_;
+    size_t end_;
+
+    // Raw key in the input, decoded by GetKey() when it has escapes; no data for the root and array elements
+    std::string_view key_;
+    bool key_escaped_;
+
+    friend class JsonLazy;
+  };
+
+  JsonLazy();
+  JsonLazy(const JsonLazy&) = delete;
+  JsonLazy& operator=(const JsonLazy&) = delete;
+
+  Element GetRoot() const;
+  bool IsValid() const;
+
+  /* Containers scanned so far and subtrees built by Materialize() */
+  size_t GetIndexedCount() const;
+  size_t GetMaterializedCount() const;
+
+  /* Json conversion to string */
+  std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  /* Parsing methods, the input must outlive the document unless it is moved in */
+  static std::unique_ptr<JsonLazy> Parse(std::string_view data, const ParseOptions& options = ParseOptions());
+  static std::unique_ptr<JsonLazy> Parse(const char* data, const ParseOptions& options = ParseOptions());
+  static std::unique_ptr<JsonLazy> Parse(std::string&& data, const ParseOptions& options = ParseOptions());
+
+  /* Without the validation pass, for input known to be valid. Invalid input gives unspecified values but is never read out of bounds */
+  static std::unique_ptr<JsonLazy> ParseTrusted(std::string_view data);
+
+private:
+  struct Member {
+    std::string_view key;
+    bool key_escaped;
+    size_t begin;
+    size_t end;
+  };
+
+  /* Children found so far, scanning resumes at next */
+  struct Container {
+    std::vector<Member> members;
+    size_t next;
+    bool complete;
+  };
+
+  bool Load(std::string_view data, bool validate = true);
+  void Clear();
+
+  Container& GetContainer(size_t begin) const;
+  bool ScanMember(Container& container, bool is_object) const;
+  std::string_view Decode(std::string_view raw) const;
+
+  /* Scanning helpers, they stop at the end of the input even when it is not valid */
+  const char* SkipWhitespace(const char* ch) const;
+  const char* SkipString(const char* ch) const;
+  const char* SkipValue(const char* ch) const;
+
+  ParseOptions options_;
+  std::string input_;
+  std::string_view data_;
+  size_t root_begin_;
+  size_t root_end_;
+
+  mutable std::unordered_map<size_t, Container> containers_;
+  mutable std::unordered_map<size_t, std::unique_ptr<Json>> materialized_;
+  mutable std::unordered_map<const char*, std::string> decoded_strings_;
+};
+
+
+template<class T> requires std::invocable<T&, const JsonLazy::Element&>
+void JsonLazy::Element::ForEachChild(T&& visitor) const
+{
+  auto type = GetType();
+  if (type != Json::ValueType::Object && type != Json::ValueType::Array) return;
+
+  auto& container = document_->GetContainer(begin_);
+
+  // Members are scanned while they are visited, the vector may grow meanwhile
+  for (size_t i = 0; i < container.members.size() || document_->ScanMember(container, type == Json::ValueType::Object); i++)
+  {
+    auto& member = container.members[i];
+    const Element child(document_, member.begin, member.end, member.key, member.key_escaped);
+
+    visitor(child);
+  }
+}
+
+#endif // !JSON_LAZY_H
@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include "json_lines.h"
+#include "json_parser.h"
+
+JsonLinesParser::JsonLinesParser(ThreadPool& pool, const ParseOptions& options)
+  : options_{ options }
+  , pool_{ pool }
+{
+}
+
+std::vector<std::unique_ptr<Json>> JsonLinesParser::Parse(std::string_view data)
+{
+  std::vector<std::unique_ptr<Json>> documents;
+
+  Parse(data, [&documents](size_t /*line*/, std::unique_ptr<Json> json) -> void {
+    documents.push_back(std::move(json));
+    });
+
+  return documents;
+}
+
+void JsonLinesParser::Parse(std::string_view data, const LineCallback& callback)
+{
+  size_t batch_size = pool_.GetThreadCount() * JSON_LINES_CHUNKS_PER_THREAD;
+  size_t offset = 0;
+  size_t first_line = 0;
+
+  while (offset < data.size())
+  {
+    std::vector<Chunk> batch;
+
+    while (offset < data.size() && batch.size() < batch_size)
+    {
+      auto& chunk = batch.emplace_back();
+      chunk.data = NextChunk(data, offset);
+      offset += chunk.data.size();
+    }
+
+    // The vector is not resized anymore, chunks can be referenced by the tasks
+    ThreadPool::Group group;
+    for (auto& chunk : batch)
+    {
+      pool_.Submit(group, [this, &chunk]() { ParseChunk(chunk); });
+    }
+    pool_.Wait(group);
+
+    for (auto& chunk : batch)
+    {
+      for (auto& [line, json] : chunk.documents)
+      {
+        callback(first_line + line, std::move(json));
+      }
+      first_line += chunk.line_count;
+    }
+  }
+}
+
+void JsonLinesParser::ParseChunk(Chunk& chunk) const
+{
+  JsonParser parser;
+  size_t begin = 0;
+
+  while (begin < chunk.data.size())
+  {
+    auto end = chunk.data.find('\n', begin);
+    if (end == std::string_view::npos) end = chunk.data.size();
+
+    auto line = chunk.data.substr(begin, end - begin);
+    auto blank = std::all_of(line.begin(), line.end(), JsonReader::IsWhitespace);
+
+    if (!blank)
+    {
+      chunk.documents.emplace_back(chunk.line_count, parser.ParseValue(line, options_));
+    }
+
+    chunk.line_count++;
+    begin = end + 1;
+  }
+}
+
+std::string_view JsonLinesParser::NextChunk(std::string_view data, size_t offset)
+{
+  if (data.size() - offset <= JSON_LINES_CHUNK_SIZE) return data.substr(offset);
+
+  // Extend the chunk up to the end of the line it cuts
+  auto end = data.find('\n', offset + JSON_LINES_CHUNK_SIZE);
+  return end == std::string_view::npos ? data.substr(offset) : data.substr(offset, end - offset + 1);
+}
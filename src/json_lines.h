@@ -0,0 +1,46 @@
+#ifndef JSON_LINES_H
+#define JSON_LINES_H
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+#include "thread_pool.h"
+
+#define JSON_LINES_CHUNK_SIZE (1024 * 1024)
+#define JSON_LINES_CHUNKS_PER_THREAD 4
+
+/*
+ * Parses newline delimited documents on a worker pool. The input is cut into
+ * chunks at line boundaries, chunks are parsed in parallel in batches and
+ * handed out in input order, so only one batch of documents is kept alive
+ * when streaming to a callback.
+ *
+ * Lines are parsed with JsonParser and the limits of the options apply to
+ * every line, a line may hold any value. Invalid lines produce Undefined
+ * documents and blank lines are skipped.
+ */
+class JsonLinesParser {
+public:
+  /* The pool may be shared, only the tasks of this parser are waited for */
+  JsonLinesParser(ThreadPool& pool, const ParseOptions& options);
+
+  std::vector<std::unique_ptr<Json>> Parse(std::string_view data);
+  void Parse(std::string_view data, const LineCallback& callback);
+
+private:
+  struct Chunk {
+    std::string_view data;
+    std::vector<std::pair<size_t, std::unique_ptr<Json>>> documents;
+    size_t line_count = 0;
+  };
+
+  void ParseChunk(Chunk& chunk) const;
+  static std::string_view NextChunk(std::string_view data, size_t offset);
+
+  ParseOptions options_;
+  ThreadPool& pool_;
+};
+
+#endif // !JSON_LINES_H
@@ -0,0 +1,239 @@
+#include <algorithm>
+
+#include "json_parallel.h"
+
+JsonParallelParser::JsonParallelParser(ThreadPool& pool, const ParseOptions& options)
+  : options_{ options }
+  , pool_{ pool }
+  , task_size_{ 0 }
+  , string_pool_{ nullptr }
+{
+}
+
+std::unique_ptr<Json> JsonParallelParser::Parse(std::string_view data)
+{
+  data_ = data;
+  tasks_.clear();
+  totals_.nodes = 0;
+  totals_.bytes = 0;
+
+  // Scalars and inputs the index rejects are left to the sequential parser, it fails them the same way
+  bool oversized = options_.max_input_size != 0 && data.size() > options_.max_input_size;
+  if (oversized || !index_.Build(data)) return Json::Parse(data, options_);
+
+  auto& positions = index_.GetPositions();
+  if (positions.empty() || (data[positions[0]] != '{' && data[positions[0]] != '['))
+  {
+    return Json::Parse(data, options_);
+  }
+
+  task_size_ = std::max<size_t>(data.size() / (pool_.GetThreadCount() * JSON_PARALLEL_TASKS_PER_THREAD), 1);
+
+  auto root = Json::CreateRoot(options_);
+  string_pool_ = root->owned_pool_.get();
+  size_t close_index = 0;
+
+  //only trailing whitespaces are allowed after the root value
+  bool valid = SplitContainer(root.get(), 1, 0, close_index) && close_index + 1 == positions.size();
+
+  if (valid)
+  {
+    ThreadPool::Group group;
+    for (auto& task : tasks_)
+    {
+      pool_.Submit(group, [this, &task]() { ParseTask(task); });
+    }
+    pool_.Wait(group);
+  }
+
+  // Task arenas hold nodes already linked into the tree, they go away with the root
+  for (auto& task : tasks_)
+  {
+    if (task.arena) root->owned_arena_->Adopt(std::move(task.arena));
+    valid = valid && task.succeeded;
+  }
+  tasks_.clear();
+
+  if (!valid)
+  {
+    root = std::make_unique<Json>();
+    root->SetType(Json::ValueType::Undefined);
+  }
+
+  return root;
+}
+
+bool JsonParallelParser::SplitContainer(Json* node, size_t node_depth, size_t open_index, size_t& close_index)
+{
+  // Nodes created here are counted like those of the tasks
+  if (options_.max_depth != 0 && node_depth > options_.max_depth) return false;
+  if (options_.max_nodes != 0 && ++totals_.nodes > options_.max_nodes) return false;
+  if (options_.max_allocated_bytes != 0 && (totals_.bytes += sizeof(Json)) > options_.max_allocated_bytes) return false;
+
+  auto& positions = index_.GetPositions();
+  bool is_object = data_[positions[open_index]] == '{';
+
+  node->SetType(is_object ? Json::ValueType::Object : Json::ValueType::Array);
+  auto& children = node->EmplaceChildren();
+
+  // Token ranges of the elements, separated by commas on this level
+  std::vector<std::pair<size_t, size_t>> ranges;
+  size_t depth = 0;
+  size_t begin = open_index + 1;
+  bool closed = false;
+
+  for (size_t i = open_index + 1; i < positions.size() && !closed; i++)
+  {
+    switch (data_[positions[i]])
+    {
+    case '{':
+    case '[':
+      depth++;
+      break;
+
+    case '}':
+    case ']':
+      if (depth > 0)
+      {
+        depth--;
+        break;
+      }
+
+      if (data_[positions[i]] != (is_object ? '}' : ']')) return false;
+      if (i > begin || !ranges.empty()) ranges.emplace_back(begin, i);
+      close_index = i;
+      closed = true;
+      break;
+
+    case ',':
+      if (depth == 0)
+      {
+        ranges.emplace_back(begin, i);
+        begin = i + 1;
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  if (!closed) return false;
+
+  children.resize(ranges.size());
+
+  for (size_t slot = 0; slot < ranges.size(); slot++)
+  {
+    auto [first, last] = ranges[slot];
+    Element element{ node, node_depth, slot, std::string_view(), std::string_view() };
+
+    if (is_object)
+    {
+      // "key" : value
+      if (last - first < 3 || data_[positions[first]] != '\"' || data_[positions[first + 1]] != ':') return false;
+      element.key = data_.substr(positions[first], positions[first + 1] - positions[first]);
+      first += 2;
+    }
+
+    if (first >= last) return false;
+    element.value = data_.substr(positions[first], positions[last] - positions[first]);
+
+    bool is_container = element.value[0] == '{' || element.value[0] == '[';
+    if (!is_container || element.value.size() <= task_size_)
+    {
+      AddElement(element);
+      continue;
+    }
+
+    // Large containers are split further, their node is created here
+    JsonReader reader;
+    std::string key;
+    if (is_object && !ReadKey(reader, element.key, key)) return false;
+
+    children[slot] = node->CreateChild(key, node->GetRoot()->owned_pool_.get());
+
+    size_t child_close = 0;
+    if (!SplitContainer(children[slot].get(), node_depth + 1, first, child_close) || child_close + 1 != last) return false;
+  }
+
+  return true;
+}
+
+void JsonParallelParser::AddElement(const Element& element)
+{
+  if (tasks_.empty() || tasks_.back().size >= task_size_) tasks_.emplace_back();
+
+  tasks_.back().elements.push_back(element);
+  tasks_.back().size += element.value.size();
+}
+
+void JsonParallelParser::ParseTask(Task& task)
+{
+  JsonArena* arena = nullptr;
+  if (options_.use_arena)
+  {
+    task.arena = std::make_unique<JsonArena>(options_.arena_chunk_size);
+    arena = task.arena.get();
+  }
+
+  if (options_.intern_keys) task.pool = std::make_unique<JsonStringPool>();
+
+  JsonReader reader;
+  JsonParser parser;
+  std::string key;
+
+  for (auto& element : task.elements)
+  {
+    key.clear();
+    if (!element.key.empty() && !ReadKey(reader, element.key, key)) return;
+
+    // Each element owns a slot, the children list itself is not resized
+    auto node = Json::CreateNode(key, element.parent, arena, task.pool.get());
+
+    if (!parser.ParseElement(element.value, node.get(), task.pool.get(), element.depth, options_, totals_)) return;
+    std::get<ChildrenList>(element.parent->value_)[element.slot] = std::move(node);
+  }
+
+  if (task.pool) MergeKeys(task);
+  task.succeeded = true;
+}
+
+void JsonParallelParser::MergeKeys(Task& task)
+{
+  // Only the distinct keys of the task go through the shared pool, the nodes are updated without the lock
+  std::unordered_map<const std::string*, const std::string*> entries;
+  {
+    std::lock_guard lock(string_pool_mutex_);
+    task.pool->InternInto(*string_pool_, entries);
+  }
+
+  std::vector<Json*> pending;
+  for (auto& element : task.elements) pending.push_back(std::get<ChildrenList>(element.parent->value_)[element.slot].get());
+
+  while (!pending.empty())
+  {
+    auto node = pending.back();
+    pending.pop_back();
+
+    if (node->key_interned_) node->SetInternedKey(entries[node->interned_key_]);
+    if (!std::holds_alternative<ChildrenList>(node->value_)) continue;
+
+    for (auto& child : std::get<ChildrenList>(node->value_)) pending.push_back(child.get());
+  }
+
+  task.pool.reset();
+}
+
+bool JsonParallelParser::ReadKey(JsonReader& reader, std::string_view token, std::string& key)
+{
+  std::string_view value;
+
+  auto ch = token.data();
+  auto end = token.data() + token.size();
+
+  if (!reader.ReadString(ch, end, value)) return false;
+  key.assign(value);
+
+  // Only whitespaces may follow the key before the colon
+  return std::all_of(ch + 1, end, JsonReader::IsWhitespace);
+}
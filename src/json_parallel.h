@@ -0,0 +1,75 @@
+#ifndef JSON_PARALLEL_H
+#define JSON_PARALLEL_H
+
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+#include "json_parser.h"
+#include "json_reader.h"
+#include "structural_index.h"
+#include "thread_pool.h"
+
+#define JSON_PARALLEL_MIN_SIZE (1024 * 1024)
+#define JSON_PARALLEL_TASKS_PER_THREAD 4
+
+/*
+ * Parses one large document on a worker pool.
+ *
+ * The structural index gives the container boundaries without looking into
+ * strings. Containers larger than the task size are split into their elements
+ * on the calling thread, elements are grouped into tasks of roughly the same
+ * size and parsed concurrently straight into their slots of the parent's
+ * children list. Arena documents give every task its own arena, adopted by
+ * the root arena once all tasks are done. Interned keys go to a string pool
+ * per task, whose entries are moved to the pool of the document at the end of
+ * the task so equal keys stay the same pointer.
+ *
+ * Every element is parsed by JsonParser. The limits of the options apply to
+ * the whole document, nodes and bytes are counted across the tasks. As with
+ * Json::Parse the root must be an object or an array.
+ */
+class JsonParallelParser {
+public:
+  /* The pool may be shared, only the tasks of this parser are waited for */
+  JsonParallelParser(ThreadPool& pool, const ParseOptions& options);
+
+  std::unique_ptr<Json> Parse(std::string_view data);
+
+private:
+  struct Element {
+    Json* parent;
+    size_t depth;
+    size_t slot;
+    std::string_view key;
+    std::string_view value;
+  };
+
+  struct Task {
+    std::vector<Element> elements;
+    size_t size = 0;
+    std::unique_ptr<JsonArena> arena;
+    std::unique_ptr<JsonStringPool> pool;
+    bool succeeded = false;
+  };
+
+  bool SplitContainer(Json* node, size_t node_depth, size_t open_index, size_t& close_index);
+  void AddElement(const Element& element);
+  void ParseTask(Task& task);
+  void MergeKeys(Task& task);
+  static bool ReadKey(JsonReader& reader, std::string_view token, std::string& key);
+
+  ParseOptions options_;
+  ThreadPool& pool_;
+  StructuralIndex index_;
+  std::string_view data_;
+  size_t task_size_;
+  std::vector<Task> tasks_;
+  ParseTotals totals_;
+  JsonStringPool* string_pool_;
+  std::mutex string_pool_mutex_;
+};
+
+#endif // !JSON_PARALLEL_H
@@ -1,34 +1,59 @@
+#include <algorithm>
+#include <array>
 #include <variant>
+#include <cctype>
+#include <cstdlib>
 
 #include "json_parser.h"
+#include "string_scanner.h"
+#include "number_parser.h"
 
 
 JsonParser::JsonParser()
-  : parsing_state_{ ParsingState::Undefined }
-  , stop_flag_{ false }
+  : progress_{ nullptr }
+  , data_begin_{ nullptr }
+  , data_end_{ nullptr }
+  , checkpoint_{ nullptr }
+  , progress_interval_{ JSON_PROGRESS_INTERVAL }
+  , stopped_{ false }
+  , scalar_root_{ false }
+  , error_{ ParseError::None }
+  , arena_{ nullptr }
+  , node_count_{ 0 }
+  , allocated_bytes_{ 0 }
+  , depth_offset_{ 0 }
+  , totals_{ nullptr }
+  , string_pool_{ nullptr }
+  , push_container_{ nullptr }
+  , push_target_{ nullptr }
+  , push_depth_{ 0 }
+  , push_size_{ 0 }
+  , push_state_{ PushState::Undefined }
+  , push_is_key_{ false }
 {
 }
 
-Json* JsonParser::AddNewPair(Json* current)
+Json* JsonParser::AddNewPair(Json* current, std::string_view key)
 {
   if (!std::holds_alternative<ChildrenList>(current->value_))
   {
-    current->value_ = ChildrenList();
+    current->EmplaceChildren();
   }
   auto& list = std::get<ChildrenList>(current->value_);
-  list.push_back(std::make_unique<Json>("", current));
+  list.push_back(current->CreateChild(key, string_pool_));
+  CountNode();
+
+  // Keeps a built key index in step, otherwise SetKey() rebuilds it for every member
+  current->IndexChild(list.back().get());
   return list.back().get();
 }
 
-void JsonParser::SetParsedValue(const std::string& value, Json* current)
+void JsonParser::SetParsedValue(std::string_view value, Json* current)
 {
   switch (current->value_type_)
   {
   case Json::ValueType::String:
-    current->value_ = value;
-    break;
-  case Json::ValueType::Number:
-    current->value_ = std::stod(value);
+    current->value_.emplace<String>(value);
     break;
   default:
     break;
@@ -36,407 +61,606 @@ void JsonParser::SetParsedValue(const std::string& value, Json* current)
 
 }
 
-std::unique_ptr<Json> JsonParser::Parse(const std::string& data, const ProgresCallback& progress_callback)
+std::unique_ptr<Json> JsonParser::Parse(std::string_view data, const ProgresCallback& progress_callback)
 {
-  auto root_ = std::make_unique<Json>("", nullptr);
-  root_->SetType(Json::ValueType::Undefined);
-  auto current = root_.get();
+  return Parse(data, ParseOptions(), progress_callback);
+}
 
-  auto it = std::begin(data);
-  auto end = std::end(data);
+std::unique_ptr<Json> JsonParser::Parse(std::string_view data, const ParseOptions& options, const ProgresCallback& progress_callback)
+{
+  options_ = options;
+  error_ = ParseError::None;
+  node_count_ = 0;
+  allocated_bytes_ = 0;
 
-  parsing_state_ = ParsingState::Started;
-  ProgressManager progress_manager{ data.size(), progress_callback, it, end, parsing_state_, stop_flag_};
+  // Oversized input is rejected before anything is allocated
+  if (options_.max_input_size != 0 && data.size() > options_.max_input_size)
+  {
+    error_ = ParseError::SizeLimit;
+    auto json = std::make_unique<Json>();
+    json->SetType(Json::ValueType::Undefined);
+    return json;
+  }
 
-  for (; it != end; it++)
+  auto root = Json::CreateRoot(options);
+  root->SetType(Json::ValueType::Undefined);
+  string_pool_ = root->owned_pool_.get();
+  arena_ = root->owned_arena_.get();
+  CountNode();
+
+  JsonProgress progress{ data.size(), progress_callback, options.progress_reporter };
+  progress_ = progress_callback ? &progress : nullptr;
+  progress_interval_ = std::max<size_t>(options.progress_interval, 1);
+  data_begin_ = data.data();
+  data_end_ = data.data() + data.size();
+  stopped_ = false;
+  Checkpoint(data_begin_);
+
+  if (!ParseDocument(root.get())) Fail(ParseError::Syntax);
+
+  // A failed parse leaves an incomplete tree behind
+  if (stopped_)
   {
-    switch (*it)
-    {
-    case '\n':
-    case '\f':
-    case '\r':
-    case '\t':
-    case '\v':
-    case ' ':
-      //ignore trailing whitespaces
-      while (it != end && std::isspace(*it)) it++;
-      it--;
-      break;
+    root = std::make_unique<Json>();
+    root->SetType(Json::ValueType::Undefined);
+  }
+  else
+  {
+    progress.Complete();
+  }
 
-    case '{':
-      current->SetType(Json::ValueType::Object);
-      parsing_state_ = ParsingState::Object;
-      break;
+  progress_ = nullptr;
+  arena_ = nullptr;
+  return root;
+}
 
-    case '[':
-      current->SetType(Json::ValueType::Array);
-      current->value_ = ChildrenList();
-      parsing_state_ = ParsingState::Array;
-      break;
+std::unique_ptr<Json> JsonParser::ParseValue(std::string_view data, const ParseOptions& options)
+{
+  // Only the first character of the document is checked differently
+  scalar_root_ = true;
+  auto json = Parse(data, options, ProgresCallback());
+  scalar_root_ = false;
 
-    default:
-      parsing_state_ = ParsingState::Undefined;
-      break;
-    }
+  return json;
+}
 
-    if (parsing_state_ != ParsingState::Undefined
-      && parsing_state_ != ParsingState::Finished
-      && parsing_state_ != ParsingState::Started)
-    {
-      if ((it + 1) != end)
-      {
-        std::invoke(GetParsingMethod(parsing_state_), this, ++it, end, current);
-        parsing_state_ = current->IsRoot() ? ParsingState::Finished : parsing_state_.load();
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-    }
+bool JsonParser::ParseElement(std::string_view data, Json* node, JsonStringPool* pool, size_t depth, const ParseOptions& options, ParseTotals& totals)
+{
+  options_ = options;
+  error_ = ParseError::None;
+  node_count_ = 0;
+  allocated_bytes_ = 0;
+  depth_offset_ = depth;
+  totals_ = &totals;
+
+  // Task arenas only hold a part of the document, bytes are counted in the totals instead
+  string_pool_ = pool;
+  arena_ = nullptr;
+  CountNode();
+
+  progress_ = nullptr;
+  progress_interval_ = std::max<size_t>(options.progress_interval, 1);
+  data_begin_ = data.data();
+  data_end_ = data.data() + data.size();
+  stopped_ = false;
+  Checkpoint(data_begin_);
+
+  scalar_root_ = true;
+  if (!ParseDocument(node)) Fail(ParseError::Syntax);
+  scalar_root_ = false;
+
+  depth_offset_ = 0;
+  totals_ = nullptr;
+  return !stopped_;
+}
 
-    if (parsing_state_ == ParsingState::Undefined)
-    {
-      root_ = std::make_unique<Json>();
-      root_->SetType(Json::ValueType::Undefined);
-      break;
-    }
+ParseError JsonParser::GetError() const
+{
+  return error_;
+}
+
+bool JsonParser::Checkpoint(const char* position)
+{
+  bool has_deadline = options_.deadline != std::chrono::steady_clock::time_point::max();
+
+  if (!stopped_ && progress_ != nullptr && position != data_begin_ && !progress_->Update(position - data_begin_))
+  {
+    Fail(ParseError::Cancelled);
+  }
+
+  if (!stopped_ && has_deadline && std::chrono::steady_clock::now() >= options_.deadline)
+  {
+    Fail(ParseError::Deadline);
   }
 
-  return root_;
+  if (stopped_) return false;
+
+  // Values start before the end of the input, a checkpoint at the end is never reached
+  checkpoint_ = progress_ == nullptr && !has_deadline ? data_end_
+    : position + std::min<size_t>(progress_interval_, data_end_ - position);
+
+  return true;
 }
 
+void JsonParser::Fail(ParseError error)
+{
+  if (error_ == ParseError::None) error_ = error;
 
+  // The parser loop stops at its next value
+  stopped_ = true;
+  checkpoint_ = data_begin_;
+}
 
-void JsonParser::ParseString(char_iterator& ch, char_iterator& end, Json* current)
+void JsonParser::CountNode()
 {
-  std::string value = "";
-  ++ch;
+  node_count_++;
 
-  while (ch != end && !stop_flag_)
+  if (options_.max_nodes != 0)
   {
-    switch (*ch)
-    {
-    case '\n':
-    case '\f':
-    case '\r':
-    case '\t':
-    case '\v':
-      parsing_state_ = ParsingState::Undefined;
-      return;
+    auto count = totals_ != nullptr ? totals_->nodes.fetch_add(1, std::memory_order_relaxed) + 1 : node_count_;
+    if (count > options_.max_nodes) Fail(ParseError::NodeLimit);
+  }
 
-    case '\\':
-      parsing_state_ = ParsingState::EscapeChar;
-      ParseEscapeChar(ch, end, value);
-      break;
+  // Arena nodes are already part of the arena size, shared totals of a parallel parse do not see the arenas
+  CountBytes(arena_ != nullptr && totals_ == nullptr ? 0 : sizeof(Json));
+}
 
-    case '\"':
-      if (current->GetType() == Json::ValueType::Object)
-      {
-        if (parsing_state_ == ParsingState::Key) {
-          current->SetKey(value);
-        }
-        parsing_state_ = ParsingState::Object;
-        return;
-      }
-      else if (current->GetType() == Json::ValueType::String)
-      {
-        SetParsedValue(value, current);
-        parsing_state_ = ParsingState::Object;
-        return;
-      }
+void JsonParser::CountBytes(size_t size)
+{
+  if (options_.max_allocated_bytes == 0) return;
 
-      else if (current->GetType() == Json::ValueType::Array) parsing_state_ = ParsingState::Array;
-      return;
-    default:
-      value.append(1, *ch);
+  // Arena documents know their arena exactly, strings and heap nodes are counted by the parser
+  allocated_bytes_ += size;
+  auto allocated = totals_ != nullptr ? totals_->bytes.fetch_add(size, std::memory_order_relaxed) + size
+    : arena_ != nullptr ? arena_->GetAllocatedBytes() + allocated_bytes_ : allocated_bytes_;
 
-      break;
-    }
-    ch++;
-  }
+  if (allocated > options_.max_allocated_bytes) Fail(ParseError::MemoryLimit);
 }
 
-void JsonParser::ParseNumber(char_iterator& ch, char_iterator& end, Json* current)
+namespace {
+
+/* Role of every byte at the start of a token */
+enum class CharClass : uint8_t {
+  Invalid,
+  Whitespace,
+  ObjectStart,
+  ObjectEnd,
+  ArrayStart,
+  ArrayEnd,
+  Comma,
+  Quote,
+  Number,
+  True,
+  False,
+  Null,
+  Count
+};
+
+constexpr std::array<CharClass, 256> char_classes = []() {
+  std::array<CharClass, 256> table{};
+
+  // Form feed and vertical tab are accepted like the reader does
+  for (auto ch : { ' ', '\t', '\n', '\r', '\f', '\v' }) table[static_cast<uint8_t>(ch)] = CharClass::Whitespace;
+  for (auto ch : { '-', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9' }) table[static_cast<uint8_t>(ch)] = CharClass::Number;
+
+  table['{'] = CharClass::ObjectStart;
+  table['}'] = CharClass::ObjectEnd;
+  table['['] = CharClass::ArrayStart;
+  table[']'] = CharClass::ArrayEnd;
+  table[','] = CharClass::Comma;
+  table['\"'] = CharClass::Quote;
+  table['t'] = CharClass::True;
+  table['f'] = CharClass::False;
+  table['n'] = CharClass::Null;
+
+  return table;
+  }();
+
+inline CharClass GetCharClass(char ch)
 {
-  std::string value = "";
-  bool decimal_point = false;
-  value.append(1, *ch);
-  ++ch;
+  return char_classes[static_cast<uint8_t>(ch)];
+}
 
-  while (ch != end && !stop_flag_)
-  {
-    switch (*ch)
-    {
-    case '\n':
-    case '\f':
-    case '\r':
-    case '\t':
-    case '\v':
-    case ' ':
-    case ',':
-    case '}':
-    case ']':
-      if (value.back() >= '0' || value.back() <= '9')
-      {
-        SetParsedValue(value, current);
-        ch--;
-        parsing_state_ = ParsingState::Object;
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-      return;
+}
 
-    case '.':
-      if (value.size() == 1 && value[0] == '-' || decimal_point == true)
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-      else
-      {
-        decimal_point = true;
-        value.append(1, *ch);
-      }
-      break;
+/*
+ * Jumps to the label handling the class of *ch. GCC and Clang take the
+ * address of every label and jump through the table, other compilers get a
+ * switch the optimizer turns into a jump table.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_COMPUTED_GOTO
+#endif
+
+#ifdef JSON_COMPUTED_GOTO
+#define JSON_DISPATCH(targets) goto *targets[static_cast<size_t>(GetCharClass(*ch))]
+#else
+#define JSON_DISPATCH(targets)                                            \
+  switch (GetCharClass(*ch))                                              \
+  {                                                                       \
+  case CharClass::ObjectStart:    goto targets##_object_start;            \
+  case CharClass::ArrayStart:     goto targets##_array_start;             \
+  case CharClass::Quote:          goto targets##_string;                  \
+  case CharClass::Number:         goto targets##_number;                  \
+  case CharClass::True:           goto targets##_true;                    \
+  case CharClass::False:          goto targets##_false;                   \
+  case CharClass::Null:           goto targets##_null;                    \
+  case CharClass::Comma:          goto targets##_comma;                   \
+  case CharClass::ObjectEnd:      goto targets##_object_end;              \
+  case CharClass::ArrayEnd:       goto targets##_array_end;               \
+  default:                        goto targets##_invalid;                 \
+  }
+#endif
 
-    case 'e':
-    case 'E':
-      if (value.back() >= '0' || value.back() <= '9')
-      {
-        value.append(1, *ch);
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-        return;
-      }
-      break;
+bool JsonParser::ParseDocument(Json* root)
+{
+  auto ch = data_begin_;
+  auto end = data_end_;
+  auto target = root;
+
+#ifdef JSON_COMPUTED_GOTO
+  // Indexed by CharClass, a value may start where a separator is expected and the other way round only on error
+  static void* const value[] = {
+    &&value_invalid, &&value_invalid, &&value_object_start, &&value_invalid, &&value_array_start, &&value_invalid,
+    &&value_invalid, &&value_string, &&value_number, &&value_true, &&value_false, &&value_null };
+  static void* const separator[] = {
+    &&value_invalid, &&value_invalid, &&value_invalid, &&separator_object_end, &&value_invalid, &&separator_array_end,
+    &&separator_comma, &&value_invalid, &&value_invalid, &&value_invalid, &&value_invalid, &&value_invalid };
+
+  static_assert(std::size(value) == static_cast<size_t>(CharClass::Count));
+  static_assert(std::size(separator) == static_cast<size_t>(CharClass::Count));
+#endif
+
+  // Open containers, innermost last; the vector is kept between documents
+  stack_.clear();
+
+  reader_.SkipWhitespace(ch, end);
+  if (ch == end || (!scalar_root_ && *ch != '{' && *ch != '[')) return false;
+
+  // A value starts at ch and is stored in target
+next_value:
+  if (ch >= checkpoint_ && !Checkpoint(ch)) return false;
+  JSON_DISPATCH(value);
+
+value_object_start:
+value_array_start:
+  {
+    bool is_object = *ch == '{';
+    target->SetType(is_object ? Json::ValueType::Object : Json::ValueType::Array);
+    target->EmplaceChildren();
+    stack_.push_back(target);
 
-    case '-':
-      if (value.back() >= 'E' || value.back() <= 'e')
-      {
-        parsing_state_ = ParsingState::Undefined;
-        return;
-      }
-      else
-      {
-        value.append(1, *ch);
-      }
-      break;
+    if (options_.max_depth != 0 && depth_offset_ + stack_.size() > options_.max_depth)
+    {
+      Fail(ParseError::DepthLimit);
+      return false;
+    }
 
-    default:
-      if (*ch >= '0' || *ch <= '9')
-      {
-        value.append(1, *ch);
-      }
+    SkipWhitespace(++ch, end);
+    if (ch == end) return false;
 
-      break;
+    if (*ch == (is_object ? '}' : ']'))
+    {
+      stack_.pop_back();
+      goto value_done;
     }
-    ch++;
+
+    target = is_object ? ParseMember(ch, end, target) : AddNewPair(target);
+    if (target == nullptr) return false;
+    goto next_value;
   }
-}
 
-void JsonParser::ParseEscapeChar(char_iterator& ch, char_iterator& end, std::string& str)
-{
-  ++ch;
+value_string:
+  {
+    std::string_view value;
+    if (!reader_.ReadString(ch, end, value)) return false;
+
+    target->SetType(Json::ValueType::String);
+    SetParsedValue(value, target);
+    CountBytes(value.size());
+    goto value_done;
+  }
 
-  switch (*ch)
+value_number:
   {
-  case 'n':
-    str.append(1, '\n');
-    break;
+    NumberValue value;
+    if (!reader_.ReadNumber(ch, end, value)) return false;
 
-  case 't':
-    str.append(1, '\t');
-    break;
+    target->SetType(Json::ValueType::Number);
+    std::visit([target](auto number) -> void { target->value_ = number; }, value);
+    goto value_done;
+  }
 
-  case 'f':
-    str.append(1, '\f');
-    break;
+value_true:
+  if (!JsonReader::ExpectKeyword(ch, end, "true")) return false;
 
-  case 'v':
-    str.append(1, '\v');
-    break;
+  target->SetType(Json::ValueType::Bool);
+  target->value_ = true;
+  ch += 3;
+  goto value_done;
 
-  case 'b':
-    str.append(1, '\b');
-    break;
+value_false:
+  if (!JsonReader::ExpectKeyword(ch, end, "false")) return false;
 
-  case 'r':
-    str.append(1, '\r');
-    break;
+  target->SetType(Json::ValueType::Bool);
+  target->value_ = false;
+  ch += 4;
+  goto value_done;
 
-  case '\\':
-    str.append(1, '\\');
-    break;
-  case '\"':
-    str.append(1, '\"');
-    break;
+value_null:
+  if (!JsonReader::ExpectKeyword(ch, end, "null")) return false;
 
-  case '\'':
-    str.append(1, '\'');
-    break;
+  target->SetType(Json::ValueType::Null);
+  ch += 3;
+  goto value_done;
 
-  case '\?':
-    str.append(1, '\?');
-    break;
+  // The value is complete, ch is at its last character
+value_done:
+  SkipWhitespace(++ch, end);
 
-  case '\a':
-    str.append(1, '\a');
-    break;
+  //only trailing whitespaces are allowed after the root value
+  if (stack_.empty()) return ch == end;
+  if (ch == end) return false;
 
-  default:
-    parsing_state_ = ParsingState::Undefined;
-    break;
+  JSON_DISPATCH(separator);
+
+separator_comma:
+  {
+    SkipWhitespace(++ch, end);
+    if (ch == end) return false;
+
+    auto container = stack_.back();
+    target = container->GetType() == Json::ValueType::Object ? ParseMember(ch, end, container) : AddNewPair(container);
+    if (target == nullptr) return false;
+    goto next_value;
   }
-  parsing_state_ = ParsingState::String;
+
+separator_object_end:
+  if (stack_.back()->GetType() != Json::ValueType::Object) return false;
+  stack_.pop_back();
+  goto value_done;
+
+separator_array_end:
+  if (stack_.back()->GetType() != Json::ValueType::Array) return false;
+  stack_.pop_back();
+  goto value_done;
+
+#ifndef JSON_COMPUTED_GOTO
+value_comma:
+value_object_end:
+value_array_end:
+separator_object_start:
+separator_array_start:
+separator_string:
+separator_number:
+separator_true:
+separator_false:
+separator_null:
+separator_invalid:
+#endif
+value_invalid:
+  return false;
+}
+
+Json* JsonParser::ParseMember(const char*& ch, const char* end, Json* object)
+{
+  std::string_view key;
+  if (*ch != '\"' || !reader_.ReadString(ch, end, key)) return nullptr;
+
+  // The member is created with its key, the view is only valid until the next read
+  auto member = AddNewPair(object, key);
+  CountBytes(key.size());
+
+  SkipWhitespace(++ch, end);
+  if (ch == end || *ch != ':') return nullptr;
+
+  SkipWhitespace(++ch, end);
+  if (ch == end) return nullptr;
+
+  return member;
+}
+
+void JsonParser::SkipWhitespace(const char*& ch, const char* end)
+{
+  // Minified input has no whitespace between tokens, the reader is not called then
+  if (ch != end && GetCharClass(*ch) == CharClass::Whitespace) reader_.SkipWhitespace(ch, end);
 }
 
-void JsonParser::ParseArray(char_iterator& ch, char_iterator& end, Json* current)
+void JsonParser::Start(const ParseOptions& options)
 {
-  while (ch != end && !stop_flag_)
+  options_ = options;
+  error_ = ParseError::None;
+  node_count_ = 0;
+  allocated_bytes_ = 0;
+  stopped_ = false;
+
+  push_root_ = Json::CreateRoot(options);
+  push_root_->SetType(Json::ValueType::Undefined);
+  string_pool_ = push_root_->owned_pool_.get();
+  arena_ = push_root_->owned_arena_.get();
+  CountNode();
+
+  push_container_ = nullptr;
+  push_target_ = nullptr;
+  push_depth_ = 0;
+  push_size_ = 0;
+  push_state_ = PushState::Value;
+  push_is_key_ = false;
+  push_token_.clear();
+}
+
+bool JsonParser::Feed(std::string_view chunk)
+{
+  if (!push_root_) Start();
+
+  // Limits are checked between the values, a failure ends the stream like a syntax error
+  push_size_ += chunk.size();
+  if (options_.max_input_size != 0 && push_size_ > options_.max_input_size) Fail(ParseError::SizeLimit);
+  if (options_.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= options_.deadline)
   {
-    switch (*ch)
+    Fail(ParseError::Deadline);
+  }
+
+  auto ch = chunk.data();
+  auto end = chunk.data() + chunk.size();
+
+  while (ch != end && push_state_ != PushState::Undefined && !stopped_)
+  {
+    switch (push_state_)
     {
-    case '\n':
-    case '\f':
-    case '\r':
-    case '\t':
-    case '\v':
-    case ' ':
+    case PushState::String:
+      ch = FeedString(ch, end);
       break;
-    case ']':
+
+    case PushState::EscapeChar:
     {
-      auto& list = std::get<ChildrenList>(current->value_);
-      if (list.size() == 1 &&
-        (*list.back()).GetType() == Json::ValueType::Undefined)
+      char decoded;
+      if (*ch == 'u')
       {
-        list.pop_back();
+        push_escape_.assign(1, 'u');
+        push_state_ = PushState::UnicodeEscape;
       }
+      else if (StringScanner::Unescape(*ch, decoded))
+      {
+        push_token_.append(1, decoded);
+        push_state_ = PushState::String;
+      }
+      else
+      {
+        push_state_ = PushState::Undefined;
+      }
+      ch++;
     }
-    return;
+      break;
 
-    case ',':
+    case PushState::UnicodeEscape:
+      ch = FeedUnicodeEscape(ch, end);
       break;
 
-    case '\"':
-    case '[':
-    case 't':
-    case 'f':
-    case 'n':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-    case '0':
-    case '-':
-      current = AddNewPair(current);
-      parsing_state_ = ParsingState::Value;
-      std::invoke(GetParsingMethod(parsing_state_), this, ch, end, current);
-      current = current->parent_;
+    case PushState::Number:
+      ch = FeedNumber(ch, end);
       break;
 
-    case '{':
-      parsing_state_ = ParsingState::Value;
-      current = AddNewPair(current);
-      current->SetType(Json::ValueType::Object);
-      std::invoke(GetParsingMethod(parsing_state_), this, ch, end, current);
-      current = current->parent_;
+    case PushState::Literal:
+      ch = FeedLiteral(ch, end);
       break;
 
     default:
+      ch = FeedStructural(ch, end);
       break;
     }
-
-    ch++;
   }
 
+  if (stopped_) push_state_ = PushState::Undefined;
+  if (push_state_ == PushState::Undefined && error_ == ParseError::None) error_ = ParseError::Syntax;
+
+  return push_state_ != PushState::Undefined;
 }
 
-void JsonParser::ParseObject(char_iterator& ch, char_iterator& end, Json* current)
+std::unique_ptr<Json> JsonParser::Finish()
 {
-  current = AddNewPair(current);
+  auto root = std::move(push_root_);
+
+  // Unfinished documents are as invalid as malformed ones
+  if (!root || push_state_ != PushState::Done)
+  {
+    if (error_ == ParseError::None) error_ = ParseError::Syntax;
+
+    root = std::make_unique<Json>();
+    root->SetType(Json::ValueType::Undefined);
+  }
 
-  current->SetType(Json::ValueType::Object);
-  std::string name = "";
-  bool is_key_set = false;
+  push_container_ = nullptr;
+  push_target_ = nullptr;
+  push_state_ = PushState::Undefined;
+  push_token_.clear();
+  arena_ = nullptr;
 
-  while (ch != end && !stop_flag_)
+  return root;
+}
+
+const char* JsonParser::FeedStructural(const char* ch, const char* end)
+{
+  while (ch != end && JsonReader::IsWhitespace(*ch)) ch++;
+  if (ch == end) return ch;
+
+  switch (push_state_)
   {
-    switch (*ch)
+  case PushState::FirstValue:
+    if (*ch == ']')
     {
-    case '\n':
-    case '\f':
-    case '\r':
-    case '\t':
-    case '\v':
-    case ' ':
+      ClosePushContainer();
       break;
+    }
+    [[fallthrough]];
 
-    case '\"':
-      if (parsing_state_ == ParsingState::Object)
-      {
-        parsing_state_ = ParsingState::Key;
-        std::invoke(GetParsingMethod(parsing_state_), this, ch, end, current);
-        is_key_set = true;
-      }
-      else {
-        parsing_state_ = ParsingState::Undefined;
-        return;
-      }
+  case PushState::Value:
+    StartPushValue(*ch);
+    break;
+
+  case PushState::FirstKey:
+    if (*ch == '}')
+    {
+      ClosePushContainer();
       break;
+    }
+    [[fallthrough]];
 
-    case '}':
+  case PushState::Key:
+    if (*ch == '\"')
     {
-      current = current->parent_;
-      auto& list = std::get<ChildrenList>(current->value_);
-      if (list.size() > 0 && list[0]->key_ == "")
-      {
-        list.pop_back();
-      }
+      push_is_key_ = true;
+      push_token_.clear();
+      push_state_ = PushState::String;
     }
-    return;
+    else
+    {
+      push_state_ = PushState::Undefined;
+    }
+    break;
 
-    case ':':
-      if (is_key_set)
-      {
-        parsing_state_ = ParsingState::Value;
-        std::invoke(GetParsingMethod(parsing_state_), this, ++ch, end, current);
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-      break;
+  case PushState::Colon:
+    push_state_ = *ch == ':' ? PushState::Value : PushState::Undefined;
+    break;
 
-    case ',':
-      current = current->parent_;
-      current = AddNewPair(current);
-      current->SetType(Json::ValueType::Object);
-      break;
+  case PushState::Next:
+  {
+    bool is_object = push_container_->GetType() == Json::ValueType::Object;
 
-    default:
-      name.append(1, *ch);
-      break;
+    if (*ch == ',')
+    {
+      push_state_ = is_object ? PushState::Key : PushState::Value;
+    }
+    else if (*ch == (is_object ? '}' : ']'))
+    {
+      ClosePushContainer();
+    }
+    else
+    {
+      push_state_ = PushState::Undefined;
     }
+  }
+    break;
 
-    ch++;
+  default:
+    //only trailing whitespaces are allowed after the root value
+    push_state_ = PushState::Undefined;
+    break;
   }
 
+  return ch + 1;
 }
 
-void JsonParser::ParseValue(char_iterator& ch, char_iterator& end, Json* current)
+const char* JsonParser::FeedString(const char* ch, const char* end)
 {
-  std::string value = "";
-
-  while (ch != end && !stop_flag_)
+  while (ch != end)
   {
+    auto run_end = StringScanner::FindSpecial(ch, end);
+    push_token_.append(ch, run_end);
+    ch = run_end;
+
+    if (ch == end) break;
+
     switch (*ch)
     {
     case '\n':
@@ -444,188 +668,197 @@ void JsonParser::ParseValue(char_iterator& ch, char_iterator& end, Json* current
     case '\r':
     case '\t':
     case '\v':
-    case ' ':
-      break;
-
-    case '\"':
-      current->SetType(Json::ValueType::String);
-      parsing_state_ = ParsingState::String;
-      std::invoke(GetParsingMethod(parsing_state_), this, ch, end, current);
-      return;
-      break;
+      push_state_ = PushState::Undefined;
+      return ch;
 
-    case 't':
-      if (ExpectKeyword(ch, end, "true"))
-      {
-        current->SetType(Json::ValueType::Bool);
-        current->value_ = true;
-        parsing_state_ = ParsingState::Object;
-        ch += 3;
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-      return;
-
-    case 'f':
-      if (ExpectKeyword(ch, end, "false"))
-      {
-        current->SetType(Json::ValueType::Bool);
-        current->value_ = false;
-        parsing_state_ = ParsingState::Object;
-        ch += 4;
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-      return;
-
-    case 'n':
-      if (ExpectKeyword(ch, end, "null"))
-      {
-        current->SetType(Json::ValueType::Null);
-        parsing_state_ = ParsingState::Object;
-        ch += 3;
-      }
-      else
-      {
-        parsing_state_ = ParsingState::Undefined;
-      }
-      return;
-
-    case '{':
-      parsing_state_ = ParsingState::Object;
-      std::invoke(GetParsingMethod(parsing_state_), this, ch, end, current);
-      return;
-
-    case '[':
-      current->SetType(Json::ValueType::Array);
-      parsing_state_ = ParsingState::Array;
-      current->value_ = ChildrenList();
-      std::invoke(GetParsingMethod(parsing_state_), this, ++ch, end, current);
-      return;
+    case '\\':
+      push_state_ = PushState::EscapeChar;
+      return ch + 1;
 
-    case '-':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-    case '0':
-      current->SetType(Json::ValueType::Number);
-      parsing_state_ = ParsingState::Number;
-      std::invoke(GetParsingMethod(parsing_state_),this, ch, end, current);
-      return;
+    case '\"':
+      CompletePushString();
+      return ch + 1;
 
     default:
-      value.append(1, *ch);
+      push_token_.append(1, *ch);
       break;
     }
-
     ch++;
   }
+
+  return ch;
+}
+
+const char* JsonParser::FeedUnicodeEscape(const char* ch, const char* end)
+{
+  // Buffered until complete, a high surrogate is decoded together with the escape after it
+  while (ch != end)
+  {
+    push_escape_.append(1, *ch++);
+
+    bool high_surrogate = (push_escape_[1] == 'd' || push_escape_[1] == 'D') && std::string_view("89abAB").find(push_escape_[2]) != std::string_view::npos;
+    if (push_escape_.size() < (high_surrogate ? 11 : 5)) continue;
+
+    const char* escape = push_escape_.data();
+    push_state_ = StringScanner::Unescape(escape, escape + push_escape_.size(), push_token_) ? PushState::String : PushState::Undefined;
+    break;
+  }
+
+  return ch;
 }
 
-JsonParser::ParsingMethodType JsonParser::GetParsingMethod(ParsingState state)
+const char* JsonParser::FeedNumber(const char* ch, const char* end)
 {
-  switch (state)
+  auto begin = ch;
+  while (ch != end && (std::isdigit(static_cast<unsigned char>(*ch))
+    || *ch == '-' || *ch == '+' || *ch == '.' || *ch == 'e' || *ch == 'E'))
   {
-  case ParsingState::Object:      return &JsonParser::ParseObject;
-  case ParsingState::Array:       return &JsonParser::ParseArray;
-  case ParsingState::Key:
-  case ParsingState::String:      return &JsonParser::ParseString;
-  case ParsingState::Number:      return &JsonParser::ParseNumber;
-  case ParsingState::Value:       return &JsonParser::ParseValue;
+    ch++;
   }
-  return nullptr;
+  push_token_.append(begin, ch);
+
+  // The delimiter is left for the structural state to validate
+  if (ch != end) CompletePushNumber();
+
+  return ch;
 }
 
-bool JsonParser::ExpectKeyword(char_iterator& ch, char_iterator& end, std::string keyword)
+const char* JsonParser::FeedLiteral(const char* ch, const char* end)
 {
-  std::string temp = "";
+  std::string_view keyword = push_token_[0] == 't' ? "true" : push_token_[0] == 'f' ? "false" : "null";
 
-  if (static_cast<size_t>(end - ch) > keyword.size())
+  while (ch != end && push_token_.size() < keyword.size())
   {
-    temp.append(ch, ch + keyword.size());
-    if (keyword == temp)
+    if (*ch != keyword[push_token_.size()])
     {
-      return true;
+      push_state_ = PushState::Undefined;
+      return ch;
+    }
+    push_token_.append(1, *ch++);
+  }
+
+  if (push_token_.size() == keyword.size())
+  {
+    if (keyword == "null")
+    {
+      push_target_->SetType(Json::ValueType::Null);
     }
     else
     {
-      return false;
+      push_target_->SetType(Json::ValueType::Bool);
+      push_target_->value_ = keyword == "true";
     }
+    push_state_ = PushState::Next;
   }
 
-  return false;
+  return ch;
 }
 
-JsonParser::ProgressManager::~ProgressManager()
+void JsonParser::StartPushValue(char ch)
 {
-  stop_flag_ = true;
-}
-
-const std::atomic<bool>& JsonParser::ProgressManager::isStopped() const
-{
-  return stop_flag_;
-}
+  // Object members are created with their key, array elements on their first character
+  auto target = push_container_ == nullptr ? push_root_.get()
+    : push_container_->GetType() == Json::ValueType::Array ? AddNewPair(push_container_)
+    : push_target_;
 
-JsonParser::ProgressManager::ProgressManager (
-  size_t data_size,
-  const ProgresCallback& progress,
-  char_iterator& begin,
-  char_iterator& end,
-  std::atomic<ParsingState>& parsing_state,
-  std::atomic<bool>& stop_flag)
-  : data_size_{ data_size }
-  , callback_{ progress }
-  , stop_flag_{ stop_flag }
-  , begin_{ begin }
-  , end_{ end }
-  , parsing_state_{ parsing_state }
-{
-  if (callback_)
+  if (push_container_ == nullptr && ch != '{' && ch != '[')
   {
-    thread_ = std::jthread(&ProgressManager::LoopProgressRead, this);
+    push_state_ = PushState::Undefined;
+    return;
   }
-}
 
-void JsonParser::ProgressManager::InvokeCallback(size_t progress)
-{
-  if (callback_)
+  push_target_ = target;
+  push_token_.clear();
+
+  switch (ch)
   {
-    stop_flag_ = !callback_(progress);
+  case '{':
+  case '[':
+    push_depth_++;
+    if (options_.max_depth != 0 && push_depth_ > options_.max_depth)
+    {
+      Fail(ParseError::DepthLimit);
+      return;
+    }
+
+    target->SetType(ch == '{' ? Json::ValueType::Object : Json::ValueType::Array);
+    target->EmplaceChildren();
+    push_container_ = target;
+    push_state_ = ch == '{' ? PushState::FirstKey : PushState::FirstValue;
+    break;
+
+  case '\"':
+    target->SetType(Json::ValueType::String);
+    push_is_key_ = false;
+    push_state_ = PushState::String;
+    break;
+
+  case '-':
+  case '1':
+  case '2':
+  case '3':
+  case '4':
+  case '5':
+  case '6':
+  case '7':
+  case '8':
+  case '9':
+  case '0':
+    target->SetType(Json::ValueType::Number);
+    push_token_.append(1, ch);
+    push_state_ = PushState::Number;
+    break;
+
+  case 't':
+  case 'f':
+  case 'n':
+    push_token_.append(1, ch);
+    push_state_ = PushState::Literal;
+    break;
+
+  default:
+    push_state_ = PushState::Undefined;
+    break;
   }
 }
 
-void JsonParser::ProgressManager::LoopProgressRead()
+void JsonParser::CompletePushString()
 {
-  std::chrono::milliseconds timespan(JSON_PROGESS_READ_TIME);
+  CountBytes(push_token_.size());
 
-  while (IsParsingInProgress())
+  if (push_is_key_)
+  {
+    push_target_ = AddNewPair(push_container_);
+    push_target_->AssignKey(push_token_, string_pool_);
+    push_state_ = PushState::Colon;
+  }
+  else
   {
-    auto current_progress = GetCurrentProgress();
-    InvokeCallback(current_progress);
-    std::this_thread::sleep_for(timespan);
+    SetParsedValue(push_token_, push_target_);
+    push_state_ = PushState::Next;
   }
-  callback_(GetCurrentProgress());
 }
 
-bool JsonParser::ProgressManager::IsParsingInProgress() const
+void JsonParser::CompletePushNumber()
 {
-  constexpr auto underlying = [](auto value) {
-    return std::underlying_type_t<ParsingState>(value);
-  };
-  return underlying(parsing_state_.load()) > underlying(JsonParser::ParsingState::Finished) && !stop_flag_;
+  NumberValue value;
+  auto begin = push_token_.data();
+  auto last = push_token_.data() + push_token_.size();
+
+  if (NumberParser::Parse(begin, last, value) == last)
+  {
+    std::visit([this](auto number) -> void { push_target_->value_ = number; }, value);
+    push_state_ = PushState::Next;
+  }
+  else
+  {
+    push_state_ = PushState::Undefined;
+  }
 }
 
-size_t JsonParser::ProgressManager::GetCurrentProgress() const
+void JsonParser::ClosePushContainer()
 {
-  return (100* (data_size_ - std::distance(begin_, end_))) / data_size_;
+  push_depth_--;
+  push_container_ = push_container_->parent_;
+  push_state_ = push_container_ == nullptr ? PushState::Done : PushState::Next;
 }
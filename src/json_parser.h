@@ -1,87 +1,123 @@
 #ifndef JSON_PARSER_H
 #define JSON_PARSER_H
 
+#include <atomic>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <thread>
+#include <vector>
 #include <iostream>
 #include "json.h"
-
-#define JSON_PROGESS_READ_TIME 1000
+#include "json_reader.h"
+#include "json_progress.h"
 
 
+/* Node and byte counts of one document parsed by several parsers at once, only kept when the limit is set */
+struct ParseTotals {
+  std::atomic<size_t> nodes{ 0 };
+  std::atomic<size_t> bytes{ 0 };
+};
 
 class JsonParser
 {
-  using char_iterator = std::string::const_iterator;
-  using ParsingMethodType = void(JsonParser::*)(char_iterator&, char_iterator&, Json*);
-
 public:
   JsonParser();
-  std::unique_ptr<Json> Parse(const std::string& data, const ProgresCallback& progress_callback);
+  std::unique_ptr<Json> Parse(std::string_view data, const ProgresCallback& progress_callback);
+  std::unique_ptr<Json> Parse(std::string_view data, const ParseOptions& options, const ProgresCallback& progress_callback);
+
+  /* Any value is accepted as the root, for documents that are parts of a larger input */
+  std::unique_ptr<Json> ParseValue(std::string_view data, const ParseOptions& options);
+
+  /* Parses a value into node, an element of a document assembled elsewhere at the given depth; limits apply to the totals */
+  bool ParseElement(std::string_view data, Json* node, JsonStringPool* pool, size_t depth, const ParseOptions& options, ParseTotals& totals);
+
+  /* Reason of the last failed Parse() call or push parse */
+  ParseError GetError() const;
+
+  /* Incremental parsing, the document is built while chunks arrive. The limits apply to the whole stream, the deadline is checked once per chunk */
+  void Start(const ParseOptions& options = ParseOptions());
+  bool Feed(std::string_view chunk);
+  std::unique_ptr<Json> Finish();
 
 private:
-  enum class ParsingState {
+  enum class PushState {
     Undefined = -1,
-    Interrupted,
-    Finished,
-    Started,
-
-    Object = 10,
-    Array,
-    Key,
+    Done,
     Value,
+    FirstValue,
+    Key,
+    FirstKey,
+    Colon,
+    Next,
     String,
+    EscapeChar,
+    UnicodeEscape,
     Number,
-    BooleanNull,
-    Null,
-    EscapeChar };
-
-  class ProgressManager {
-  public:
-    ProgressManager(
-      size_t data_size,
-      const ProgresCallback& progress,
-      char_iterator& begin,
-      char_iterator& end,
-      std::atomic<ParsingState>& parsing_state,
-      std::atomic<bool>& stop_flag
-    );
-
-    ~ProgressManager();
-
-    const std::atomic<bool>& isStopped() const;
-  private:
-
-    void InvokeCallback(size_t progress);
-    void LoopProgressRead();
-    bool IsParsingInProgress() const;
-    size_t GetCurrentProgress() const;
-
-    size_t data_size_;
-    ProgresCallback callback_;
-    std::jthread thread_;
-    std::atomic<bool>& stop_flag_;
-    const std::atomic<ParsingState>& parsing_state_;
-    const char_iterator& begin_;
-    const char_iterator& end_;
-  };
-
-  /* Parsing methods */
-  void ParseString(char_iterator& ch, char_iterator& end, Json* current);
-  void ParseArray(char_iterator& ch, char_iterator& end, Json* current);
-  void ParseObject(char_iterator& ch, char_iterator& end, Json* current);
-  void ParseValue(char_iterator& ch, char_iterator& end, Json* current);
-  void ParseNumber(char_iterator& ch, char_iterator& end, Json* current);
-  void ParseEscapeChar(char_iterator& ch, char_iterator& end, std::string& str);
-  ParsingMethodType GetParsingMethod(ParsingState state);
-  bool ExpectKeyword(char_iterator& ch, char_iterator& end, std::string expected_value);
+    Literal };
+
+  /* Parsing methods, one loop over the input with the open containers on an explicit stack */
+  bool ParseDocument(Json* root);
+  Json* ParseMember(const char*& ch, const char* end, Json* object);
+  void SkipWhitespace(const char*& ch, const char* end);
+
+  /* Push parsing methods, each consumes input and returns the new position */
+  const char* FeedStructural(const char* ch, const char* end);
+  const char* FeedString(const char* ch, const char* end);
+  const char* FeedUnicodeEscape(const char* ch, const char* end);
+  const char* FeedNumber(const char* ch, const char* end);
+  const char* FeedLiteral(const char* ch, const char* end);
+  void StartPushValue(char ch);
+  void CompletePushString();
+  void CompletePushNumber();
+  void ClosePushContainer();
+
+  /* Progress and cancellation, the loop only compares against the next checkpoint */
+  bool Checkpoint(const char* position);
+
+  /* Resource limits, a failure stops the parser loop at its next value */
+  void Fail(ParseError error);
+  void CountNode();
+  void CountBytes(size_t size);
 
   /* Maniputaion methods */
-  void SetParsedValue(const std::string& value, Json* current);
-  Json* AddNewPair(Json* current);
-  std::atomic<bool> stop_flag_;
-  std::atomic<ParsingState> parsing_state_;
+  void SetParsedValue(std::string_view value, Json* current);
+  Json* AddNewPair(Json* current, std::string_view key = std::string_view());
+
+  /* Progress of the running Parse() call */
+  JsonProgress* progress_;
+  const char* data_begin_;
+  const char* data_end_;
+  const char* checkpoint_;
+  size_t progress_interval_;
+  bool stopped_;
+  bool scalar_root_;
+
+  /* Limits of the running Parse() call and what they are measured against */
+  ParseOptions options_;
+  ParseError error_;
+  JsonArena* arena_;
+  size_t node_count_;
+  size_t allocated_bytes_;
+  size_t depth_offset_;
+  ParseTotals* totals_;
+
+  std::vector<Json*> stack_;
+
+  JsonReader reader_;
+
+  /* Pool of the document being built, keys are interned when it is set */
+  JsonStringPool* string_pool_;
+
+  /* Push parser state kept between chunks, only the current token is buffered */
+  std::unique_ptr<Json> push_root_;
+  Json* push_container_;
+  Json* push_target_;
+  size_t push_depth_;
+  size_t push_size_;
+  PushState push_state_;
+  bool push_is_key_;
+  std::string push_token_;
+  std::string push_escape_;
 };
 
 
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <charconv>
+#include <variant>
+
+#include "json_pointer.h"
+
+JsonPointer::JsonPointer()
+  : valid_{ true }
+{
+}
+
+JsonPointer::JsonPointer(std::string_view pointer)
+  : valid_{ pointer.empty() || pointer[0] == '/' }
+{
+  if (!valid_ || pointer.empty()) return;
+
+  // Every token starts after a '/', the first one right after the leading slash
+  size_t begin = 1;
+
+  for (;;)
+  {
+    auto end = std::min(pointer.find('/', begin), pointer.size());
+    auto raw = pointer.substr(begin, end - begin);
+
+    std::string key;
+    key.reserve(raw.size());
+
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+      if (raw[i] != '~')
+      {
+        key.push_back(raw[i]);
+        continue;
+      }
+
+      if (i + 1 == raw.size() || (raw[i + 1] != '0' && raw[i + 1] != '1'))
+      {
+        tokens_.clear();
+        valid_ = false;
+        return;
+      }
+
+      key.push_back(raw[++i] == '0' ? '~' : '/');
+    }
+
+    uint32_t index = no_index;
+    ParseIndex(key, index);
+    tokens_.emplace_back(std::move(key), index);
+
+    if (end == pointer.size()) break;
+    begin = end + 1;
+  }
+}
+
+bool JsonPointer::IsValid() const
+{
+  return valid_;
+}
+
+size_t JsonPointer::GetDepth() const
+{
+  return tokens_.size();
+}
+
+std::string JsonPointer::ToString() const
+{
+  std::string pointer;
+
+  for (auto& token : tokens_)
+  {
+    pointer.push_back('/');
+
+    for (auto ch : token.key)
+    {
+      if (ch == '~') pointer.append("~0");
+      else if (ch == '/') pointer.append("~1");
+      else pointer.push_back(ch);
+    }
+  }
+
+  return pointer;
+}
+
+Json* JsonPointer::Resolve(Json& json) const
+{
+  return const_cast<Json*>(Resolve(static_cast<const Json&>(json)));
+}
+
+const Json* JsonPointer::Resolve(const Json& json) const
+{
+  if (!valid_ || !json.IsValid()) return nullptr;
+
+  auto node = &json;
+
+  for (auto& token : tokens_)
+  {
+    auto type = node->GetType();
+    if ((type != Json::ValueType::Object && type != Json::ValueType::Array)
+      || !std::holds_alternative<ChildrenList>(node->GetValue())) return nullptr;
+
+    auto& children = std::get<ChildrenList>(node->GetValue());
+
+    if (type == Json::ValueType::Array)
+    {
+      if (token.index >= children.size()) return nullptr;
+
+      node = children[token.index].get();
+      continue;
+    }
+
+    // Same layout as the last document, one comparison
+    auto hint = token.hint.load(std::memory_order_relaxed);
+    if (hint < children.size() && std::string_view(children[hint]->GetKey()) == token.key)
+    {
+      node = children[hint].get();
+      continue;
+    }
+
+    const Json* found = nullptr;
+    for (uint32_t i = 0; i < children.size(); i++)
+    {
+      if (std::string_view(children[i]->GetKey()) == token.key)
+      {
+        token.hint.store(i, std::memory_order_relaxed);
+        found = children[i].get();
+        break;
+      }
+    }
+
+    if (found == nullptr) return nullptr;
+    node = found;
+  }
+
+  return node;
+}
+
+JsonCompact::Element JsonPointer::Resolve(const JsonCompact& document) const
+{
+  if (!valid_ || !document.IsValid()) return JsonCompact::Element();
+
+  auto element = document.GetRoot();
+
+  for (auto& token : tokens_)
+  {
+    auto type = element.GetType();
+
+    if (type == Json::ValueType::Array)
+    {
+      // Elements are contiguous, the index is the position
+      if (token.index == no_index) return JsonCompact::Element();
+
+      element = element[static_cast<int>(token.index)];
+      if (!element.IsValid()) return element;
+      continue;
+    }
+
+    if (type != Json::ValueType::Object) return JsonCompact::Element();
+
+    auto hint = token.hint.load(std::memory_order_relaxed);
+    if (hint < element.Size())
+    {
+      auto member = element[static_cast<int>(hint)];
+      if (member.GetKey() == token.key)
+      {
+        element = member;
+        continue;
+      }
+    }
+
+    JsonCompact::Element found;
+    auto size = static_cast<uint32_t>(element.Size());
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+      auto member = element[static_cast<int>(i)];
+      if (member.GetKey() == token.key)
+      {
+        token.hint.store(i, std::memory_order_relaxed);
+        found = member;
+        break;
+      }
+    }
+
+    if (!found.IsValid()) return found;
+    element = found;
+  }
+
+  return element;
+}
+
+bool JsonPointer::ParseIndex(std::string_view token, uint32_t& index)
+{
+  // Array indices are decimal without leading zeros, "-" names the element past the end and never resolves
+  if (token.empty() || (token.size() > 1 && token[0] == '0')) return false;
+
+  auto end = token.data() + token.size();
+  auto [ptr, error] = std::from_chars(token.data(), end, index);
+
+  return error == std::errc() && ptr == end && index != no_index;
+}
+
+
+JsonPointer::Token::Token(std::string key, uint32_t index)
+  : key{ std::move(key) }
+  , index{ index }
+  , hint{ 0 }
+{
+}
+
+JsonPointer::Token::Token(const Token& other)
+  : key{ other.key }
+  , index{ other.index }
+  , hint{ other.hint.load(std::memory_order_relaxed) }
+{
+}
+
+JsonPointer::Token& JsonPointer::Token::operator=(const Token& other)
+{
+  key = other.key;
+  index = other.index;
+  hint.store(other.hint.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  return *this;
+}
@@ -0,0 +1,60 @@
+#ifndef JSON_POINTER_H
+#define JSON_POINTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+#include "json_compact.h"
+
+/*
+ * RFC 6901 JSON Pointer, parsed and unescaped once and then resolved against
+ * any number of documents.
+ *
+ * Every reference token remembers the position of the member it matched last
+ * time. Documents sharing a layout find each member at the remembered position
+ * after one key comparison, other documents fall back to a scan and update
+ * the hint. Hints are only ever checked against the document, so a pointer
+ * may be resolved from several threads at once.
+ */
+class JsonPointer {
+public:
+  JsonPointer();
+
+  /* Invalid when the syntax is wrong: no leading '/' or a '~' not followed by '0' or '1' */
+  explicit JsonPointer(std::string_view pointer);
+
+  bool IsValid() const;
+  size_t GetDepth() const;
+
+  /* Pointer text with the tokens escaped again */
+  std::string ToString() const;
+
+  /* Referenced value, nullptr or an invalid element when it does not exist */
+  Json* Resolve(Json& json) const;
+  const Json* Resolve(const Json& json) const;
+  JsonCompact::Element Resolve(const JsonCompact& document) const;
+
+private:
+  static constexpr uint32_t no_index = static_cast<uint32_t>(-1);
+
+  struct Token {
+    Token(std::string key, uint32_t index);
+    Token(const Token& other);
+    Token& operator=(const Token& other);
+
+    std::string key;
+    uint32_t index;                           // array index, no_index when the token is not one
+    mutable std::atomic<uint32_t> hint;       // member position matched last time
+  };
+
+  static bool ParseIndex(std::string_view token, uint32_t& index);
+
+  std::vector<Token> tokens_;
+  bool valid_;
+};
+
+#endif // !JSON_POINTER_H
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "json_progress.h"
+
+/*
+ * One thread reporting the progress of every parse that asked for it. It is
+ * started with the first registration and sleeps while nothing is parsed.
+ */
+class JsonProgressReporter {
+public:
+  static JsonProgressReporter& GetInstance()
+  {
+    static JsonProgressReporter reporter;
+    return reporter;
+  }
+
+  void Register(JsonProgress* progress)
+  {
+    std::lock_guard lock(mutex_);
+    parses_.push_back(progress);
+
+    if (!thread_.joinable()) thread_ = std::jthread([this](std::stop_token token) { Loop(token); });
+    wakeup_.notify_one();
+  }
+
+  /* No callback of the parse is running or will run once this returns */
+  void Unregister(JsonProgress* progress)
+  {
+    std::lock_guard lock(mutex_);
+    parses_.erase(std::remove(parses_.begin(), parses_.end(), progress), parses_.end());
+  }
+
+private:
+  void Loop(std::stop_token token)
+  {
+    std::unique_lock lock(mutex_);
+
+    while (!token.stop_requested())
+    {
+      if (parses_.empty())
+      {
+        wakeup_.wait(lock, token, [this] { return !parses_.empty(); });
+        continue;
+      }
+
+      wakeup_.wait_for(lock, token, std::chrono::milliseconds(JSON_PROGRESS_REPORT_TIME), [] { return false; });
+      for (auto progress : parses_) progress->Report();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable_any wakeup_;
+  std::vector<JsonProgress*> parses_;
+  std::jthread thread_;
+};
+
+
+JsonProgress::JsonProgress(size_t data_size, const ProgresCallback& callback, bool use_reporter)
+  : data_size_{ data_size }
+  , callback_{ callback }
+  , use_reporter_{ use_reporter && callback }
+  , consumed_{ 0 }
+  , cancelled_{ false }
+{
+  if (use_reporter_) JsonProgressReporter::GetInstance().Register(this);
+}
+
+JsonProgress::~JsonProgress()
+{
+  if (use_reporter_) JsonProgressReporter::GetInstance().Unregister(this);
+}
+
+bool JsonProgress::Update(size_t consumed)
+{
+  // Nothing is ordered by the counter, the reporter only needs an eventual value
+  consumed_.store(consumed, std::memory_order_relaxed);
+  if (!use_reporter_ && callback_) Report();
+
+  return !IsCancelled();
+}
+
+void JsonProgress::Complete()
+{
+  if (use_reporter_)
+  {
+    JsonProgressReporter::GetInstance().Unregister(this);
+    use_reporter_ = false;
+  }
+
+  consumed_.store(data_size_, std::memory_order_relaxed);
+  if (callback_ && !IsCancelled()) Report();
+}
+
+bool JsonProgress::IsCancelled() const
+{
+  return cancelled_.load(std::memory_order_relaxed);
+}
+
+void JsonProgress::Report()
+{
+  if (IsCancelled()) return;
+
+  auto consumed = consumed_.load(std::memory_order_relaxed);
+  auto percent = data_size_ == 0 ? 100 : (100 * consumed) / data_size_;
+
+  if (!callback_(percent)) cancelled_.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,54 @@
+#ifndef JSON_PROGRESS_H
+#define JSON_PROGRESS_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+/* Bytes parsed between two progress updates */
+#define JSON_PROGRESS_INTERVAL (64 * 1024)
+
+/* Period of the shared reporter thread in milliseconds */
+#define JSON_PROGRESS_REPORT_TIME 100
+
+using ProgresCallback = std::function<bool(size_t)>;
+
+/*
+ * Progress of one parse. The parser publishes the number of consumed bytes
+ * at checkpoints, every progress interval, and learns about cancellation at
+ * the same time. The callback gets the percentage of the input parsed so
+ * far and cancels by returning false.
+ *
+ * The callback is invoked either inline from the checkpoint or by the
+ * reporter thread shared by every parse, which only reads the published
+ * counter.
+ */
+class JsonProgress {
+public:
+  JsonProgress(size_t data_size, const ProgresCallback& callback, bool use_reporter);
+  JsonProgress(const JsonProgress&) = delete;
+  JsonProgress& operator=(const JsonProgress&) = delete;
+  ~JsonProgress();
+
+  /* Publishes the consumed bytes, false once the parse is cancelled */
+  bool Update(size_t consumed);
+
+  /* Last report once the whole input was parsed */
+  void Complete();
+
+  bool IsCancelled() const;
+
+private:
+  void Report();
+
+  size_t data_size_;
+  ProgresCallback callback_;
+  bool use_reporter_;
+
+  std::atomic<size_t> consumed_;
+  std::atomic<bool> cancelled_;
+
+  friend class JsonProgressReporter;
+};
+
+#endif // !JSON_PROGRESS_H
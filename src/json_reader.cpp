@@ -0,0 +1,139 @@
+#include "json_reader.h"
+#include "string_scanner.h"
+
+bool JsonReader::ReadString(const char*& ch, const char* end, std::string_view& value)
+{
+  ++ch;
+
+  bool buffered = false;
+
+  while (ch != end)
+  {
+    // Skip over the run of plain characters in one go
+    auto run_begin = ch;
+    ch = StringScanner::FindSpecial(ch, end);
+
+    if (ch == end) break;
+
+    // Strings without escapes are referenced in place, the rest is decoded into the buffer
+    if (*ch == '\"' && !buffered)
+    {
+      value = std::string_view(run_begin, ch - run_begin);
+      return true;
+    }
+
+    if (!buffered)
+    {
+      string_buffer_.clear();
+      buffered = true;
+    }
+    string_buffer_.append(run_begin, ch);
+
+    switch (*ch)
+    {
+    case '\n':
+    case '\f':
+    case '\r':
+    case '\t':
+    case '\v':
+      return false;
+
+    case '\\':
+      if (++ch == end || !StringScanner::Unescape(ch, end, string_buffer_)) return false;
+      break;
+
+    case '\"':
+      value = string_buffer_;
+      return true;
+
+    default:
+      string_buffer_.append(1, *ch);
+      break;
+    }
+    ch++;
+  }
+
+  return false;
+}
+
+bool JsonReader::ReadRawString(const char*& ch, const char* end, std::string_view& raw, bool& escaped)
+{
+  ++ch;
+
+  auto begin = ch;
+  escaped = false;
+
+  while (ch != end)
+  {
+    ch = StringScanner::FindSpecial(ch, end);
+
+    if (ch == end) break;
+
+    switch (*ch)
+    {
+    case '\n':
+    case '\f':
+    case '\r':
+    case '\t':
+    case '\v':
+      return false;
+
+    case '\\':
+      // Escapes are only validated here, decoding is left to the caller
+      if (++ch == end || !StringScanner::SkipEscape(ch, end)) return false;
+      escaped = true;
+      break;
+
+    case '\"':
+      raw = std::string_view(begin, ch - begin);
+      return true;
+
+    default:
+      break;
+    }
+    ch++;
+  }
+
+  return false;
+}
+
+bool JsonReader::ReadNumber(const char*& ch, const char* end, NumberValue& value)
+{
+  auto number_end = NumberParser::Parse(ch, end, value);
+  if (number_end == nullptr) return false;
+
+  // Number has to be followed by a delimiter
+  if (number_end != end)
+  {
+    switch (*number_end)
+    {
+    case '\n':
+    case '\f':
+    case '\r':
+    case '\t':
+    case '\v':
+    case ' ':
+    case ',':
+    case '}':
+    case ']':
+      break;
+
+    default:
+      return false;
+    }
+  }
+
+  ch = number_end - 1;
+  return true;
+}
+
+void JsonReader::SkipWhitespace(const char*& ch, const char* end)
+{
+  while (ch != end && IsWhitespace(*ch)) ch++;
+}
+
+bool JsonReader::ExpectKeyword(const char* ch, const char* end, std::string_view keyword)
+{
+  return static_cast<size_t>(end - ch) >= keyword.size()
+    && std::string_view(ch, keyword.size()) == keyword;
+}
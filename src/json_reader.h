@@ -0,0 +1,35 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <string>
+#include <string_view>
+
+#include "number_parser.h"
+
+/*
+ * Token readers shared by all parsers. Readers start at the first character
+ * of a token and leave ch at its last character.
+ */
+class JsonReader {
+public:
+  bool ReadString(const char*& ch, const char* end, std::string_view& value);
+  bool ReadRawString(const char*& ch, const char* end, std::string_view& raw, bool& escaped);
+  bool ReadNumber(const char*& ch, const char* end, NumberValue& value);
+  static void SkipWhitespace(const char*& ch, const char* end);
+
+  static bool ExpectKeyword(const char* ch, const char* end, std::string_view keyword);
+
+  /* Whitespace between tokens, form feed and vertical tab included; every scanner of validated input uses this one */
+  static bool IsWhitespace(char ch);
+
+private:
+  /* Backing storage for strings containing escapes */
+  std::string string_buffer_;
+};
+
+inline bool JsonReader::IsWhitespace(char ch)
+{
+  return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\f' || ch == '\v';
+}
+
+#endif // !JSON_READER_H
@@ -0,0 +1,238 @@
+#ifndef JSON_SAX_H
+#define JSON_SAX_H
+
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "json.h"
+#include "json_reader.h"
+
+/*
+ * Handler with every event accepted and ignored. Handlers derive from it and
+ * hide only the events they need, calls are resolved at compile time.
+ * Returning false from an event stops parsing.
+ */
+class JsonSaxHandler {
+public:
+  bool OnStartObject() { return true; }
+  bool OnEndObject(size_t /*count*/) { return true; }
+  bool OnStartArray() { return true; }
+  bool OnEndArray(size_t /*count*/) { return true; }
+  bool OnKey(std::string_view /*key*/) { return true; }
+  bool OnString(std::string_view /*value*/) { return true; }
+  bool OnNumber(Number /*value*/) { return true; }
+  bool OnInt64(Integer /*value*/) { return true; }
+  bool OnUInt64(Unsigned /*value*/) { return true; }
+  bool OnBool(Bool /*value*/) { return true; }
+  bool OnNull() { return true; }
+};
+
+/*
+ * Handlers providing the raw events get keys and strings exactly as they are
+ * in the input, with escapes validated but not decoded.
+ */
+template<class Handler>
+concept JsonRawStringHandler = requires(Handler& handler, std::string_view raw, bool escaped) {
+  { handler.OnRawKey(raw, escaped) } -> std::convertible_to<bool>;
+  { handler.OnRawString(raw, escaped) } -> std::convertible_to<bool>;
+};
+
+/*
+ * Strict parser reporting events to Handler instead of building a document.
+ * Open containers are kept on an explicit stack, so the nesting depth is
+ * limited by max_depth (0 for no limit) and memory, never by the call stack.
+ * Views passed to the handler are only valid during the call.
+ */
+template<class Handler>
+class JsonSaxParser {
+public:
+  JsonSaxParser(Handler& handler, size_t max_depth = 0);
+
+  bool Parse(std::string_view data);
+
+private:
+  struct Level {
+    bool is_object;
+    size_t count;
+  };
+
+  bool ParseDocument(const char*& ch, const char* end);
+  bool ParseScalar(const char*& ch, const char* end);
+  bool ParseKey(const char*& ch, const char* end);
+  bool ParseString(const char*& ch, const char* end, bool is_key);
+  bool ParseLiteral(const char*& ch, const char* end);
+  bool EndContainer();
+
+  Handler& handler_;
+  JsonReader reader_;
+  size_t max_depth_;
+  std::vector<Level> stack_;
+};
+
+template<class Handler>
+JsonSaxParser<Handler>::JsonSaxParser(Handler& handler, size_t max_depth)
+  : handler_{ handler }
+  , max_depth_{ max_depth }
+{
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::Parse(std::string_view data)
+{
+  auto ch = data.data();
+  auto end = data.data() + data.size();
+
+  reader_.SkipWhitespace(ch, end);
+
+  stack_.clear();
+  if (ch == end || !ParseDocument(ch, end)) return false;
+
+  //only trailing whitespaces are allowed after the root value
+  reader_.SkipWhitespace(++ch, end);
+  return ch == end;
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::ParseDocument(const char*& ch, const char* end)
+{
+  while (true)
+  {
+    // A value starts at ch
+    if (ch == end) return false;
+
+    if (*ch == '{' || *ch == '[')
+    {
+      bool is_object = *ch == '{';
+
+      if (max_depth_ != 0 && stack_.size() >= max_depth_) return false;
+      if (!(is_object ? handler_.OnStartObject() : handler_.OnStartArray())) return false;
+      stack_.push_back(Level{ is_object, 0 });
+
+      reader_.SkipWhitespace(++ch, end);
+      if (ch == end) return false;
+
+      if (*ch != (is_object ? '}' : ']'))
+      {
+        if (is_object && !ParseKey(ch, end)) return false;
+        continue;
+      }
+
+      if (!EndContainer()) return false;
+    }
+    else if (!ParseScalar(ch, end))
+    {
+      return false;
+    }
+
+    // The value ends at ch, closing brackets may end several containers in a row
+    while (true)
+    {
+      if (stack_.empty()) return true;
+      stack_.back().count++;
+
+      reader_.SkipWhitespace(++ch, end);
+      if (ch == end) return false;
+
+      bool is_object = stack_.back().is_object;
+
+      if (*ch == ',')
+      {
+        reader_.SkipWhitespace(++ch, end);
+        if (is_object && !ParseKey(ch, end)) return false;
+        break;
+      }
+
+      if (*ch != (is_object ? '}' : ']') || !EndContainer()) return false;
+    }
+  }
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::ParseScalar(const char*& ch, const char* end)
+{
+  switch (*ch)
+  {
+  case '\"':
+    return ParseString(ch, end, false);
+
+  case 't':
+  case 'f':
+  case 'n':
+    return ParseLiteral(ch, end);
+
+  case '-':
+  case '1':
+  case '2':
+  case '3':
+  case '4':
+  case '5':
+  case '6':
+  case '7':
+  case '8':
+  case '9':
+  case '0':
+  {
+    NumberValue value;
+    if (!reader_.ReadNumber(ch, end, value)) return false;
+    if (std::holds_alternative<Integer>(value)) return handler_.OnInt64(std::get<Integer>(value));
+    if (std::holds_alternative<Unsigned>(value)) return handler_.OnUInt64(std::get<Unsigned>(value));
+    return handler_.OnNumber(std::get<Number>(value));
+  }
+
+  default:
+    return false;
+  }
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::ParseKey(const char*& ch, const char* end)
+{
+  // Leaves ch at the first character of the member value
+  if (ch == end || *ch != '\"' || !ParseString(ch, end, true)) return false;
+
+  reader_.SkipWhitespace(++ch, end);
+  if (ch == end || *ch != ':') return false;
+
+  reader_.SkipWhitespace(++ch, end);
+  return true;
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::EndContainer()
+{
+  auto level = stack_.back();
+  stack_.pop_back();
+
+  return level.is_object ? handler_.OnEndObject(level.count) : handler_.OnEndArray(level.count);
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::ParseString(const char*& ch, const char* end, bool is_key)
+{
+  std::string_view value;
+
+  if constexpr (JsonRawStringHandler<Handler>)
+  {
+    bool escaped = false;
+    if (!reader_.ReadRawString(ch, end, value, escaped)) return false;
+    return is_key ? handler_.OnRawKey(value, escaped) : handler_.OnRawString(value, escaped);
+  }
+  else
+  {
+    if (!reader_.ReadString(ch, end, value)) return false;
+    return is_key ? handler_.OnKey(value) : handler_.OnString(value);
+  }
+}
+
+template<class Handler>
+bool JsonSaxParser<Handler>::ParseLiteral(const char*& ch, const char* end)
+{
+  std::string_view keyword = *ch == 't' ? "true" : *ch == 'f' ? "false" : "null";
+  if (!JsonReader::ExpectKeyword(ch, end, keyword)) return false;
+
+  ch += keyword.size() - 1;
+  return keyword == "null" ? handler_.OnNull() : handler_.OnBool(keyword == "true");
+}
+
+#endif // !JSON_SAX_H
@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <variant>
+#include <vector>
+
+#include "json_serializer.h"
+#include "string_scanner.h"
+
+/* Longest shortest round-trip double plus the ".0" suffix */
+#define JSON_NUMBER_MAX_SIZE 32
+
+JsonSerializer::JsonSerializer(std::string& output, const SerializeOptions& options)
+  : output_{ output }
+  , size_{ output.size() }
+  , options_{ options }
+  , failed_{ false }
+  , depth_{ 0 }
+  , first_{ true }
+  , after_key_{ false }
+{
+}
+
+JsonSerializer::JsonSerializer(const WriteCallback& callback, const SerializeOptions& options)
+  : buffer_(JSON_WRITE_BUFFER_SIZE, '\0')
+  , output_{ buffer_ }
+  , size_{ 0 }
+  , options_{ options }
+  , callback_{ callback }
+  , failed_{ false }
+  , depth_{ 0 }
+  , first_{ true }
+  , after_key_{ false }
+{
+}
+
+JsonSerializer::~JsonSerializer()
+{
+  Finish();
+}
+
+void JsonSerializer::Serialize(const Json& json)
+{
+  if (!json.IsValid()) return;
+  if (!json.IsRoot() && !json.IsArrayElement()) WriteKey(json.GetKey());
+
+  SerializeValue(json);
+}
+
+void JsonSerializer::SerializeValue(const Json& json)
+{
+  // Containers are tracked on the heap, depth does not reach the call stack
+  struct Frame {
+    const ChildrenList* children;
+    size_t next;
+    bool is_object;
+  };
+
+  std::vector<Frame> stack;
+  const Json* node = &json;
+
+  while (true)
+  {
+    if (node != nullptr)
+    {
+      auto type = node->GetType();
+      if (type == Json::ValueType::Object || type == Json::ValueType::Array)
+      {
+        bool is_object = type == Json::ValueType::Object;
+        is_object ? StartObject() : StartArray();
+        stack.push_back(Frame{ std::get_if<ChildrenList>(&node->GetValue()), 0, is_object });
+      }
+      else
+      {
+        SerializeScalar(*node);
+      }
+    }
+
+    if (stack.empty()) break;
+
+    auto& frame = stack.back();
+    if (frame.children != nullptr && frame.next < frame.children->size())
+    {
+      node = (*frame.children)[frame.next++].get();
+      if (!node->IsValid()) node = nullptr;
+      else if (!node->IsRoot() && !node->IsArrayElement()) WriteKey(node->GetKey());
+      continue;
+    }
+
+    frame.is_object ? EndObject() : EndArray();
+    stack.pop_back();
+    node = nullptr;
+  }
+}
+
+void JsonSerializer::SerializeScalar(const Json& json)
+{
+  auto& value = json.GetValue();
+
+  switch (json.GetType())
+  {
+  case Json::ValueType::String:
+    WriteString(std::get<String>(value));
+    break;
+
+  case Json::ValueType::Number:
+    // Integers are printed exactly, without the floating point round trip
+    if (std::holds_alternative<Integer>(value)) WriteNumber(std::get<Integer>(value));
+    else if (std::holds_alternative<Unsigned>(value)) WriteNumber(std::get<Unsigned>(value));
+    else WriteNumber(std::get<Number>(value));
+    break;
+
+  case Json::ValueType::Bool:
+    WriteBool(std::get<Bool>(value));
+    break;
+
+  case Json::ValueType::Null:
+    WriteNull();
+    break;
+
+  default:
+    break;
+  }
+}
+
+void JsonSerializer::StartObject()
+{
+  BeforeValue();
+  Put('{');
+  depth_++;
+  first_ = true;
+}
+
+void JsonSerializer::EndObject()
+{
+  depth_--;
+  if (!first_) NewLine();
+  Put('}');
+  first_ = false;
+}
+
+void JsonSerializer::StartArray()
+{
+  BeforeValue();
+  Put('[');
+  depth_++;
+  first_ = true;
+}
+
+void JsonSerializer::EndArray()
+{
+  depth_--;
+  if (!first_) NewLine();
+  Put(']');
+  first_ = false;
+}
+
+void JsonSerializer::WriteKey(std::string_view key)
+{
+  BeforeValue();
+  WriteEscaped(key);
+  Put(options_.pretty ? std::string_view(": ") : std::string_view(":"));
+  after_key_ = true;
+}
+
+void JsonSerializer::WriteString(std::string_view value)
+{
+  BeforeValue();
+  WriteEscaped(value);
+}
+
+void JsonSerializer::WriteNumber(Number value)
+{
+  BeforeValue();
+
+  // JSON has no representation for infinities and NaN
+  if (!std::isfinite(value))
+  {
+    Put("null");
+    return;
+  }
+
+  auto begin = Reserve(JSON_NUMBER_MAX_SIZE);
+  auto end = std::to_chars(begin, begin + JSON_NUMBER_MAX_SIZE, value).ptr;
+
+  // Integral doubles keep a fraction, so they are read back as doubles
+  if (std::find_if(begin, end, [](char ch) { return ch == '.' || ch == 'e'; }) == end)
+  {
+    *end++ = '.';
+    *end++ = '0';
+  }
+
+  size_ += end - begin;
+}
+
+void JsonSerializer::WriteNumber(Integer value)
+{
+  BeforeValue();
+
+  auto begin = Reserve(JSON_NUMBER_MAX_SIZE);
+  size_ += std::to_chars(begin, begin + JSON_NUMBER_MAX_SIZE, value).ptr - begin;
+}
+
+void JsonSerializer::WriteNumber(Unsigned value)
+{
+  BeforeValue();
+
+  auto begin = Reserve(JSON_NUMBER_MAX_SIZE);
+  size_ += std::to_chars(begin, begin + JSON_NUMBER_MAX_SIZE, value).ptr - begin;
+}
+
+void JsonSerializer::WriteBool(Bool value)
+{
+  BeforeValue();
+  Put(value ? std::string_view("true") : std::string_view("false"));
+}
+
+void JsonSerializer::WriteNull()
+{
+  BeforeValue();
+  Put("null");
+}
+
+bool JsonSerializer::Finish()
+{
+  if (callback_) Flush();
+  else output_.resize(size_);
+
+  return !failed_;
+}
+
+bool JsonSerializer::IsFailed() const
+{
+  return failed_;
+}
+
+char* JsonSerializer::Reserve(size_t size)
+{
+  if (size_ + size <= output_.size()) return output_.data() + size_;
+
+  if (callback_) Flush();
+
+  // The string is grown ahead of the writes, Finish() cuts off the unused tail
+  if (size_ + size > output_.size())
+  {
+    output_.resize(std::max(output_.size() * 2, size_ + size + 256));
+  }
+
+  return output_.data() + size_;
+}
+
+void JsonSerializer::Flush()
+{
+  // After a failure the output is dropped, the caller learns it from Finish()
+  if (size_ > 0 && !failed_) failed_ = !callback_(std::string_view(output_.data(), size_));
+  size_ = 0;
+}
+
+void JsonSerializer::Put(char ch)
+{
+  *Reserve(1) = ch;
+  size_++;
+}
+
+void JsonSerializer::Put(std::string_view str)
+{
+  // Long runs go to the callback directly instead of through the buffer
+  if (callback_ && str.size() > output_.size())
+  {
+    Flush();
+    if (!failed_) failed_ = !callback_(str);
+    return;
+  }
+
+  std::memcpy(Reserve(str.size()), str.data(), str.size());
+  size_ += str.size();
+}
+
+void JsonSerializer::WriteEscaped(std::string_view str)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+
+  auto ch = str.data();
+  auto end = str.data() + str.size();
+  auto run_end = StringScanner::FindSpecial(ch, end);
+
+  // Most strings need no escaping and are copied in one go, unless they would outgrow a fixed buffer
+  if (run_end == end && !(callback_ && str.size() + 2 > output_.size()))
+  {
+    auto out = Reserve(str.size() + 2);
+    out[0] = '\"';
+    std::memcpy(out + 1, str.data(), str.size());
+    out[str.size() + 1] = '\"';
+    size_ += str.size() + 2;
+    return;
+  }
+
+  Put('\"');
+
+  while (ch != end)
+  {
+    Put(std::string_view(ch, run_end - ch));
+    ch = run_end;
+
+    if (ch == end) break;
+
+    // Escapes take at most six bytes
+    auto special = static_cast<unsigned char>(*ch++);
+    auto out = Reserve(6);
+    auto begin = out;
+
+    *out++ = '\\';
+
+    switch (special)
+    {
+    case '\"':  *out++ = '\"'; break;
+    case '\\':  *out++ = '\\'; break;
+    case '\b':  *out++ = 'b'; break;
+    case '\f':  *out++ = 'f'; break;
+    case '\n':  *out++ = 'n'; break;
+    case '\r':  *out++ = 'r'; break;
+    case '\t':  *out++ = 't'; break;
+    default:
+      *out++ = 'u';
+      *out++ = '0';
+      *out++ = '0';
+      *out++ = hex[special >> 4];
+      *out++ = hex[special & 0xF];
+      break;
+    }
+
+    size_ += out - begin;
+    run_end = StringScanner::FindSpecial(ch, end);
+  }
+
+  Put('\"');
+}
+
+void JsonSerializer::BeforeValue()
+{
+  // A value following its key shares the line and needs no comma
+  if (after_key_)
+  {
+    after_key_ = false;
+    return;
+  }
+
+  if (depth_ == 0) return;
+
+  if (!first_) Put(',');
+  first_ = false;
+  NewLine();
+}
+
+void JsonSerializer::NewLine()
+{
+  if (!options_.pretty) return;
+
+  auto size = options_.indent * depth_;
+  auto out = Reserve(size + 1);
+
+  *out = '\n';
+  std::memset(out + 1, ' ', size);
+  size_ += size + 1;
+}
@@ -0,0 +1,75 @@
+#ifndef JSON_SERIALIZER_H
+#define JSON_SERIALIZER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+
+#define JSON_WRITE_BUFFER_SIZE (64 * 1024)
+
+/*
+ * Writes JSON text straight into a string buffer. The buffer is grown ahead
+ * of the writes and trimmed by Finish(), strings are escaped run by run with
+ * the SIMD scanner and doubles are printed in the shortest form that reads
+ * back to the same value.
+ *
+ * With a callback the buffer has a fixed size instead and is handed to the
+ * callback whenever it fills up, so memory does not depend on the output size.
+ *
+ * The token methods keep track of commas and indentation, they are shared by
+ * every document type.
+ */
+class JsonSerializer {
+public:
+  JsonSerializer(std::string& output, const SerializeOptions& options = SerializeOptions());
+  JsonSerializer(const WriteCallback& callback, const SerializeOptions& options = SerializeOptions());
+  JsonSerializer(const JsonSerializer&) = delete;
+  JsonSerializer& operator=(const JsonSerializer&) = delete;
+  ~JsonSerializer();
+
+  /* Node with its subtree, object members are written with their key; the tree is walked without recursion */
+  void Serialize(const Json& json);
+  void SerializeValue(const Json& json);
+
+  void StartObject();
+  void EndObject();
+  void StartArray();
+  void EndArray();
+  void WriteKey(std::string_view key);
+  void WriteString(std::string_view value);
+  void WriteNumber(Number value);
+  void WriteNumber(Integer value);
+  void WriteNumber(Unsigned value);
+  void WriteBool(Bool value);
+  void WriteNull();
+
+  /* Trims the output to the written size or flushes the buffer, false when the callback failed */
+  bool Finish();
+  bool IsFailed() const;
+
+private:
+  char* Reserve(size_t size);
+  void Flush();
+  void Put(char ch);
+  void Put(std::string_view str);
+  void WriteEscaped(std::string_view str);
+  void BeforeValue();
+  void NewLine();
+  void SerializeScalar(const Json& json);
+
+  std::string buffer_;
+  std::string& output_;
+  size_t size_;
+  SerializeOptions options_;
+
+  WriteCallback callback_;
+  bool failed_;
+
+  size_t depth_;
+  bool first_;
+  bool after_key_;
+};
+
+#endif // !JSON_SERIALIZER_H
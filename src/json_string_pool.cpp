@@ -0,0 +1,32 @@
+#include "json_string_pool.h"
+
+const std::string* JsonStringPool::Intern(std::string_view str)
+{
+  auto it = strings_.find(str);
+  if (it != strings_.end()) return &*it;
+
+  bytes_ += str.size();
+  return &*strings_.emplace(str).first;
+}
+
+const std::string* JsonStringPool::Find(std::string_view str) const
+{
+  auto it = strings_.find(str);
+  return it != strings_.end() ? &*it : nullptr;
+}
+
+size_t JsonStringPool::GetCount() const
+{
+  return strings_.size();
+}
+
+size_t JsonStringPool::GetBytes() const
+{
+  return bytes_;
+}
+
+void JsonStringPool::InternInto(JsonStringPool& pool, std::unordered_map<const std::string*, const std::string*>& entries) const
+{
+  entries.reserve(entries.size() + strings_.size());
+  for (auto& str : strings_) entries[&str] = pool.Intern(str);
+}
@@ -0,0 +1,45 @@
+#ifndef JSON_STRING_POOL_H
+#define JSON_STRING_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+/*
+ * Table of unique strings shared by the nodes of one document. Keys repeated
+ * by every element of an array of objects are stored once and the nodes refer
+ * to the entry, so two keys interned in the same pool are equal exactly when
+ * they are the same pointer. Entries live as long as the pool.
+ */
+class JsonStringPool {
+public:
+  JsonStringPool() = default;
+  JsonStringPool(const JsonStringPool&) = delete;
+  JsonStringPool& operator=(const JsonStringPool&) = delete;
+
+  const std::string* Intern(std::string_view str);
+
+  /* Entry of an interned string, nullptr when the pool does not have it */
+  const std::string* Find(std::string_view str) const;
+
+  /* Number of unique strings and their total length */
+  size_t GetCount() const;
+  size_t GetBytes() const;
+
+  /* Interns every entry into another pool, entries maps the entries of this pool to those of the other one */
+  void InternInto(JsonStringPool& pool, std::unordered_map<const std::string*, const std::string*>& entries) const;
+
+private:
+  struct Hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+  };
+
+  std::unordered_set<std::string, Hash, std::equal_to<>> strings_;
+  size_t bytes_ = 0;
+};
+
+#endif // !JSON_STRING_POOL_H
@@ -0,0 +1,542 @@
+#include <bit>
+#include <string>
+#include <vector>
+
+#include "json_tape.h"
+#include "string_scanner.h"
+
+JsonTape::JsonTape()
+{
+}
+
+JsonTape::Element JsonTape::GetRoot() const
+{
+  if (!IsValid()) return Element();
+  return Element(this, 0);
+}
+
+bool JsonTape::IsValid() const
+{
+  return !tape_.empty();
+}
+
+size_t JsonTape::GetTapeSize() const
+{
+  return tape_.size();
+}
+
+std::string JsonTape::ToString(const SerializeOptions& options) const
+{
+  return GetRoot().ToString(options);
+}
+
+std::unique_ptr<JsonTape> JsonTape::Parse(std::string_view data)
+{
+  auto tape = std::make_unique<JsonTape>();
+  JsonTapeBuilder builder(*tape, false);
+  JsonSaxParser<JsonTapeBuilder> parser(builder);
+
+  if (!parser.Parse(data)) tape->Clear();
+  return tape;
+}
+
+std::unique_ptr<JsonTape> JsonTape::Parse(const char* data)
+{
+  return Parse(std::string_view(data));
+}
+
+std::unique_ptr<JsonTape> JsonTape::Parse(std::string&& data)
+{
+  auto tape = std::make_unique<JsonTape>();
+
+  // The tape owns the input, so its strings can be referenced in place
+  tape->input_ = std::move(data);
+  JsonTapeBuilder builder(*tape, true);
+  JsonSaxParser<JsonTapeBuilder> parser(builder);
+
+  if (!parser.Parse(tape->input_)) tape->Clear();
+  return tape;
+}
+
+JsonTape::Tag JsonTape::GetTag(uint64_t entry)
+{
+  return static_cast<Tag>(entry >> tag_shift);
+}
+
+uint64_t JsonTape::GetPayload(uint64_t entry)
+{
+  return entry & payload_mask;
+}
+
+std::string_view JsonTape::GetString(size_t index) const
+{
+  auto payload = GetPayload(tape_[index]);
+  auto source = static_cast<StringSource>(payload >> source_shift);
+  auto offset = payload & offset_mask;
+  auto length = tape_[index + 1];
+
+  switch (source)
+  {
+  case StringSource::Input:
+    return std::string_view(input_).substr(offset, length);
+
+  case StringSource::EscapedInput:
+  {
+    // Decode once and point the entry at the decoded copy
+    auto& decoded = decoded_strings_.emplace_back();
+    StringScanner::Unescape(std::string_view(input_).substr(offset, length), decoded);
+
+    auto entry = (static_cast<uint64_t>(Tag::String) << tag_shift)
+      | (static_cast<uint64_t>(StringSource::Decoded) << source_shift)
+      | (decoded_strings_.size() - 1);
+    const_cast<JsonTape*>(this)->tape_[index] = entry;
+    const_cast<JsonTape*>(this)->tape_[index + 1] = decoded.size();
+    return decoded;
+  }
+
+  case StringSource::Decoded:
+    return decoded_strings_[offset];
+
+  default:
+    return std::string_view(strings_).substr(offset, length);
+  }
+}
+
+size_t JsonTape::StartContainer(Tag tag)
+{
+  tape_.push_back(static_cast<uint64_t>(tag) << tag_shift);
+  return tape_.size() - 1;
+}
+
+bool JsonTape::EndContainer(size_t start, Tag tag, size_t count)
+{
+  // The jump offset has 32 bits, larger tapes could not be navigated
+  if (tape_.size() + 1 > next_max) return false;
+
+  tape_.push_back((static_cast<uint64_t>(tag) << tag_shift) | start);
+
+  auto next = static_cast<uint64_t>(tape_.size());
+  auto saturated = static_cast<uint64_t>(count < count_max ? count : count_max);
+  tape_[start] |= (saturated << 32) | next;
+
+  return true;
+}
+
+void JsonTape::AppendString(std::string_view str)
+{
+  tape_.push_back((static_cast<uint64_t>(Tag::String) << tag_shift) | strings_.size());
+  tape_.push_back(str.size());
+  strings_.append(str);
+}
+
+void JsonTape::AppendInputString(std::string_view raw, bool escaped)
+{
+  auto source = escaped ? StringSource::EscapedInput : StringSource::Input;
+  auto offset = static_cast<uint64_t>(raw.data() - input_.data());
+
+  tape_.push_back((static_cast<uint64_t>(Tag::String) << tag_shift)
+    | (static_cast<uint64_t>(source) << source_shift)
+    | offset);
+  tape_.push_back(raw.size());
+}
+
+void JsonTape::AppendNumber(Number value)
+{
+  tape_.push_back(static_cast<uint64_t>(Tag::Double) << tag_shift);
+  tape_.push_back(std::bit_cast<uint64_t>(value));
+}
+
+void JsonTape::AppendNumber(Integer value)
+{
+  tape_.push_back(static_cast<uint64_t>(Tag::Int64) << tag_shift);
+  tape_.push_back(std::bit_cast<uint64_t>(value));
+}
+
+void JsonTape::AppendNumber(Unsigned value)
+{
+  tape_.push_back(static_cast<uint64_t>(Tag::UInt64) << tag_shift);
+  tape_.push_back(value);
+}
+
+void JsonTape::AppendLiteral(Tag tag)
+{
+  tape_.push_back(static_cast<uint64_t>(tag) << tag_shift);
+}
+
+void JsonTape::Clear()
+{
+  tape_.clear();
+  strings_.clear();
+  input_.clear();
+  decoded_strings_.clear();
+}
+
+
+JsonTape::Element::Element()
+  : tape_{ nullptr }
+  , index_{ 0 }
+  , key_index_{ npos }
+{
+}
+
+JsonTape::Element::Element(const JsonTape* tape, size_t index, size_t key_index)
+  : tape_{ tape }
+  , index_{ index }
+  , key_index_{ key_index }
+{
+}
+
+Json::ValueType JsonTape::Element::GetType() const
+{
+  if (!IsValid()) return Json::ValueType::Undefined;
+
+  switch (GetTag())
+  {
+  case Tag::StartObject:  return Json::ValueType::Object;
+  case Tag::StartArray:   return Json::ValueType::Array;
+  case Tag::String:       return Json::ValueType::String;
+  case Tag::Double:
+  case Tag::Int64:
+  case Tag::UInt64:       return Json::ValueType::Number;
+  case Tag::True:
+  case Tag::False:        return Json::ValueType::Bool;
+  case Tag::Null:         return Json::ValueType::Null;
+  default:                return Json::ValueType::Undefined;
+  }
+}
+
+std::string_view JsonTape::Element::GetKey() const
+{
+  if (!IsValid() || key_index_ == npos) return std::string_view();
+  return tape_->GetString(key_index_);
+}
+
+std::string_view JsonTape::Element::GetString() const
+{
+  if (GetType() != Json::ValueType::String) return std::string_view();
+  return tape_->GetString(index_);
+}
+
+Number JsonTape::Element::GetNumber() const
+{
+  if (GetType() != Json::ValueType::Number) return Number();
+
+  auto raw = tape_->tape_[index_ + 1];
+  switch (GetTag())
+  {
+  case Tag::Int64:        return static_cast<Number>(std::bit_cast<Integer>(raw));
+  case Tag::UInt64:       return static_cast<Number>(raw);
+  default:                return std::bit_cast<Number>(raw);
+  }
+}
+
+Integer JsonTape::Element::GetInt64() const
+{
+  if (GetType() != Json::ValueType::Number) return Integer();
+
+  auto raw = tape_->tape_[index_ + 1];
+  switch (GetTag())
+  {
+  case Tag::Int64:        return std::bit_cast<Integer>(raw);
+  case Tag::UInt64:       return static_cast<Integer>(raw);
+  default:                return static_cast<Integer>(std::bit_cast<Number>(raw));
+  }
+}
+
+Unsigned JsonTape::Element::GetUInt64() const
+{
+  if (GetType() != Json::ValueType::Number) return Unsigned();
+
+  auto raw = tape_->tape_[index_ + 1];
+  switch (GetTag())
+  {
+  case Tag::Int64:        return static_cast<Unsigned>(std::bit_cast<Integer>(raw));
+  case Tag::UInt64:       return raw;
+  default:                return static_cast<Unsigned>(std::bit_cast<Number>(raw));
+  }
+}
+
+bool JsonTape::Element::IsInteger() const
+{
+  return IsValid() && (GetTag() == Tag::Int64 || GetTag() == Tag::UInt64);
+}
+
+Bool JsonTape::Element::GetBool() const
+{
+  return IsValid() && GetTag() == Tag::True;
+}
+
+size_t JsonTape::Element::Size() const
+{
+  auto type = GetType();
+  if (type != Json::ValueType::Object && type != Json::ValueType::Array) return 0;
+
+  auto count = (GetPayload(tape_->tape_[index_]) >> 32) & count_max;
+  if (count < count_max) return count;
+
+  // Saturated counter, count children by walking the container
+  count = 0;
+  ForEachChild([&count](const Element&) { count++; });
+  return count;
+}
+
+bool JsonTape::Element::IsValid() const
+{
+  return tape_ != nullptr && index_ < tape_->tape_.size();
+}
+
+bool JsonTape::Element::IsArrayElement() const
+{
+  return IsValid() && key_index_ == npos && index_ != 0;
+}
+
+JsonTape::Element JsonTape::Element::operator[](std::string_view key) const
+{
+  if (GetType() != Json::ValueType::Object) return Element();
+
+  auto end = GetNext() - 1;
+  auto index = index_ + 1;
+
+  while (index < end)
+  {
+    Element value(tape_, index + 2, index);
+    if (tape_->GetString(index) == key) return value;
+
+    index = value.GetNext();
+  }
+
+  return Element();
+}
+
+JsonTape::Element JsonTape::Element::operator[](int index) const
+{
+  auto type = GetType();
+  if (type != Json::ValueType::Object && type != Json::ValueType::Array) return Element();
+
+  // The stored count rejects indices past the end without walking the children
+  auto count = (GetPayload(tape_->tape_[index_]) >> 32) & count_max;
+  if (index < 0 || (count < count_max && static_cast<size_t>(index) >= count)) return Element();
+
+  auto end = GetNext() - 1;
+  auto position = index_ + 1;
+
+  // Children differ in size, each one is skipped by its end offset until the requested one
+  for (int current = 0; position < end; current++)
+  {
+    Element child = type == Json::ValueType::Object
+      ? Element(tape_, position + 2, position)
+      : Element(tape_, position);
+
+    if (current == index) return child;
+    position = child.GetNext();
+  }
+
+  return Element();
+}
+
+std::string JsonTape::Element::ToString(const SerializeOptions& options) const
+{
+  std::string json_string;
+
+  if (IsValid())
+  {
+    JsonSerializer serializer(json_string, options);
+    Serialize(serializer);
+    serializer.Finish();
+  }
+
+  return json_string;
+}
+
+JsonTape::Tag JsonTape::Element::GetTag() const
+{
+  return JsonTape::GetTag(tape_->tape_[index_]);
+}
+
+size_t JsonTape::Element::GetNext() const
+{
+  switch (GetTag())
+  {
+  case Tag::StartObject:
+  case Tag::StartArray:
+    return static_cast<size_t>(GetPayload(tape_->tape_[index_]) & next_max);
+
+  case Tag::String:
+  case Tag::Double:
+  case Tag::Int64:
+  case Tag::UInt64:
+    return index_ + 2;
+
+  default:
+    return index_ + 1;
+  }
+}
+
+void JsonTape::Element::Serialize(JsonSerializer& serializer) const
+{
+  if (key_index_ != npos) serializer.WriteKey(GetKey());
+
+  // One pass over the entries, the open containers only remember whether they are objects
+  std::vector<bool> objects;
+  bool expect_key = false;
+  auto end = GetNext();
+
+  for (auto index = index_; index < end;)
+  {
+    Element entry(tape_, index);
+    auto tag = entry.GetTag();
+
+    // Object entries alternate between the key string and the value
+    if (expect_key && tag != Tag::EndObject)
+    {
+      serializer.WriteKey(tape_->GetString(index));
+      index += 2;
+      expect_key = false;
+      continue;
+    }
+
+    switch (tag)
+    {
+    case Tag::StartObject:
+      serializer.StartObject();
+      objects.push_back(true);
+      break;
+
+    case Tag::StartArray:
+      serializer.StartArray();
+      objects.push_back(false);
+      break;
+
+    case Tag::EndObject:
+      serializer.EndObject();
+      objects.pop_back();
+      break;
+
+    case Tag::EndArray:
+      serializer.EndArray();
+      objects.pop_back();
+      break;
+
+    case Tag::String:
+      serializer.WriteString(entry.GetString());
+      break;
+
+    case Tag::Double:
+      serializer.WriteNumber(entry.GetNumber());
+      break;
+
+    case Tag::Int64:
+      serializer.WriteNumber(entry.GetInt64());
+      break;
+
+    case Tag::UInt64:
+      serializer.WriteNumber(entry.GetUInt64());
+      break;
+
+    case Tag::True:
+    case Tag::False:
+      serializer.WriteBool(entry.GetBool());
+      break;
+
+    case Tag::Null:
+      serializer.WriteNull();
+      break;
+
+    default:
+      break;
+    }
+
+    // Start entries are followed by their first child, not by their jump target
+    index = tag == Tag::StartObject || tag == Tag::StartArray ? index + 1 : entry.GetNext();
+    expect_key = !objects.empty() && objects.back();
+  }
+}
+
+
+JsonTapeBuilder::JsonTapeBuilder(JsonTape& tape, bool zero_copy)
+  : tape_{ tape }
+  , zero_copy_{ zero_copy }
+{
+}
+
+bool JsonTapeBuilder::OnStartObject()
+{
+  starts_.push_back(tape_.StartContainer(JsonTape::Tag::StartObject));
+  return true;
+}
+
+bool JsonTapeBuilder::OnEndObject(size_t count)
+{
+  if (!tape_.EndContainer(starts_.back(), JsonTape::Tag::EndObject, count)) return false;
+
+  starts_.pop_back();
+  return true;
+}
+
+bool JsonTapeBuilder::OnStartArray()
+{
+  starts_.push_back(tape_.StartContainer(JsonTape::Tag::StartArray));
+  return true;
+}
+
+bool JsonTapeBuilder::OnEndArray(size_t count)
+{
+  if (!tape_.EndContainer(starts_.back(), JsonTape::Tag::EndArray, count)) return false;
+
+  starts_.pop_back();
+  return true;
+}
+
+bool JsonTapeBuilder::OnRawKey(std::string_view raw, bool escaped)
+{
+  return OnRawString(raw, escaped);
+}
+
+bool JsonTapeBuilder::OnRawString(std::string_view raw, bool escaped)
+{
+  if (zero_copy_)
+  {
+    tape_.AppendInputString(raw, escaped);
+  }
+  else if (escaped)
+  {
+    buffer_.clear();
+    StringScanner::Unescape(raw, buffer_);
+    tape_.AppendString(buffer_);
+  }
+  else
+  {
+    tape_.AppendString(raw);
+  }
+  return true;
+}
+
+bool JsonTapeBuilder::OnNumber(Number value)
+{
+  tape_.AppendNumber(value);
+  return true;
+}
+
+bool JsonTapeBuilder::OnInt64(Integer value)
+{
+  tape_.AppendNumber(value);
+  return true;
+}
+
+bool JsonTapeBuilder::OnUInt64(Unsigned value)
+{
+  tape_.AppendNumber(value);
+  return true;
+}
+
+bool JsonTapeBuilder::OnBool(Bool value)
+{
+  tape_.AppendLiteral(value ? JsonTape::Tag::True : JsonTape::Tag::False);
+  return true;
+}
+
+bool JsonTapeBuilder::OnNull()
+{
+  tape_.AppendLiteral(JsonTape::Tag::Null);
+  return true;
+}
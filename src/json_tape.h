@@ -0,0 +1,195 @@
+#ifndef JSON_TAPE_H
+#define JSON_TAPE_H
+
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <deque>
+
+#include "json.h"
+#include "json_sax.h"
+#include "json_serializer.h"
+
+/*
+ * Read-mostly document stored as a contiguous tape of 64-bit entries.
+ *
+ * Every entry keeps a tag in its top byte and a 56-bit payload:
+ *  - '{' / '[' : index one past the matching end entry (low 32 bits)
+ *                and the number of children (bits 32-55)
+ *  - '}' / ']' : index of the matching start entry
+ *  - '"'       : offset of the string, the next entry holds the length; bits
+ *                54-55 select the storage (see StringSource)
+ *  - 'd'       : the next entry holds the raw bits of the double
+ *  - 'l' / 'u' : the next entry holds the bits of the signed / unsigned
+ *                64-bit integer
+ *  - 't' / 'f' / 'n' : literals without payload
+ *
+ * Object members are stored as a key string followed by the value.
+ *
+ * A tape parsed from an rvalue string takes ownership of the input and refers
+ * to keys and strings in place. Strings with escapes are decoded on first
+ * access, so the first read of such a string is not thread safe.
+ */
+class JsonTape {
+public:
+  enum class Tag : uint8_t {
+    StartObject = '{',
+    EndObject = '}',
+    StartArray = '[',
+    EndArray = ']',
+    String = '"',
+    Double = 'd',
+    Int64 = 'l',
+    UInt64 = 'u',
+    True = 't',
+    False = 'f',
+    Null = 'n',
+  };
+
+  class Element {
+  public:
+    Element();
+    Element(const JsonTape* tape, size_t index, size_t key_index = npos);
+
+    Json::ValueType GetType() const;
+    std::string_view GetKey() const;
+    std::string_view GetString() const;
+    Number GetNumber() const;
+    Integer GetInt64() const;
+    Unsigned GetUInt64() const;
+    Bool GetBool() const;
+    size_t Size() const;
+
+    bool IsValid() const;
+    bool IsArrayElement() const;
+    bool IsInteger() const;
+
+    Element operator[](std::string_view key) const;
+    Element operator[](int index) const;
+
+    template<class T> requires std::invocable<T&, const Element&>
+    void ForEachChild(T&& visitor) const;
+
+    /* Json conversion to string */
+    std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    Tag GetTag() const;
+    size_t GetNext() const;
+    void Serialize(JsonSerializer& serializer) const;
+
+    const JsonTape* tape_;
+    size_t index_;
+    size_t key_index_;
+  };
+
+  JsonTape();
+
+  Element GetRoot() const;
+  bool IsValid() const;
+  size_t GetTapeSize() const;
+
+  /* Json conversion to string */
+  std::string ToString(const SerializeOptions& options = SerializeOptions()) const;
+
+  /* Parsing methods */
+  static std::unique_ptr<JsonTape> Parse(std::string_view data);
+  static std::unique_ptr<JsonTape> Parse(const char* data);
+  static std::unique_ptr<JsonTape> Parse(std::string&& data);
+
+private:
+  enum class StringSource : uint8_t {
+    Buffer,
+    Input,
+    EscapedInput,
+    Decoded,
+  };
+
+  static constexpr int tag_shift = 56;
+  static constexpr int source_shift = 54;
+  static constexpr uint64_t payload_mask = (uint64_t(1) << tag_shift) - 1;
+  static constexpr uint64_t offset_mask = (uint64_t(1) << source_shift) - 1;
+  static constexpr uint64_t count_max = 0xFFFFFF;
+  static constexpr uint64_t next_max = 0xFFFFFFFF;
+
+  static Tag GetTag(uint64_t entry);
+  static uint64_t GetPayload(uint64_t entry);
+  std::string_view GetString(size_t index) const;
+
+  /* Building methods, used by JsonTapeBuilder */
+  size_t StartContainer(Tag tag);
+  bool EndContainer(size_t start, Tag tag, size_t count);
+  void AppendString(std::string_view str);
+  void AppendInputString(std::string_view raw, bool escaped);
+  void AppendNumber(Number value);
+  void AppendNumber(Integer value);
+  void AppendNumber(Unsigned value);
+  void AppendLiteral(Tag tag);
+  void Clear();
+
+  std::vector<uint64_t> tape_;
+  std::string strings_;
+
+  /* Zero-copy mode, strings refer to the owned input */
+  std::string input_;
+  mutable std::deque<std::string> decoded_strings_;
+
+  friend class JsonTapeBuilder;
+};
+
+/*
+ * SAX handler appending events to a tape. In zero-copy mode strings are
+ * referenced in the input owned by the tape, otherwise they are copied and
+ * decoded right away.
+ */
+class JsonTapeBuilder : public JsonSaxHandler {
+public:
+  JsonTapeBuilder(JsonTape& tape, bool zero_copy);
+
+  bool OnStartObject();
+  bool OnEndObject(size_t count);
+  bool OnStartArray();
+  bool OnEndArray(size_t count);
+  bool OnRawKey(std::string_view raw, bool escaped);
+  bool OnRawString(std::string_view raw, bool escaped);
+  bool OnNumber(Number value);
+  bool OnInt64(Integer value);
+  bool OnUInt64(Unsigned value);
+  bool OnBool(Bool value);
+  bool OnNull();
+
+private:
+  JsonTape& tape_;
+  bool zero_copy_;
+  std::vector<size_t> starts_;
+  std::string buffer_;
+};
+
+
+template<class T> requires std::invocable<T&, const JsonTape::Element&>
+void JsonTape::Element::ForEachChild(T&& visitor) const
+{
+  auto type = GetType();
+  if (type != Json::ValueType::Object && type != Json::ValueType::Array) return;
+
+  auto end = GetNext() - 1;
+  auto index = index_ + 1;
+
+  while (index < end)
+  {
+    Element child = type == Json::ValueType::Object
+      ? Element(tape_, index + 2, index)
+      : Element(tape_, index);
+
+    visitor(static_cast<const Element&>(child));
+    index = child.GetNext();
+  }
+}
+
+#endif // !JSON_TAPE_H
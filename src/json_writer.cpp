@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <climits>
+
+#include "json_writer.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+JsonWriter::JsonWriter(std::string& output, const SerializeOptions& options)
+  : serializer_{ output, options }
+{
+}
+
+JsonWriter::JsonWriter(FILE* file, const SerializeOptions& options)
+  : serializer_{ FileCallback(file), options }
+{
+}
+
+JsonWriter::JsonWriter(int fd, const SerializeOptions& options)
+  : serializer_{ DescriptorCallback(fd), options }
+{
+}
+
+JsonWriter::JsonWriter(const WriteCallback& callback, const SerializeOptions& options)
+  : serializer_{ callback, options }
+{
+}
+
+JsonWriter& JsonWriter::StartObject()
+{
+  serializer_.StartObject();
+  return *this;
+}
+
+JsonWriter& JsonWriter::EndObject()
+{
+  serializer_.EndObject();
+  return *this;
+}
+
+JsonWriter& JsonWriter::StartArray()
+{
+  serializer_.StartArray();
+  return *this;
+}
+
+JsonWriter& JsonWriter::EndArray()
+{
+  serializer_.EndArray();
+  return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key)
+{
+  serializer_.WriteKey(key);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Value(std::string_view value)
+{
+  serializer_.WriteString(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Value(const char* value)
+{
+  return Value(std::string_view(value));
+}
+
+JsonWriter& JsonWriter::Value(const Json& value)
+{
+  serializer_.SerializeValue(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Null()
+{
+  serializer_.WriteNull();
+  return *this;
+}
+
+bool JsonWriter::Finish()
+{
+  return serializer_.Finish();
+}
+
+WriteCallback JsonWriter::FileCallback(FILE* file)
+{
+  return [file](std::string_view data) {
+    return std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    };
+}
+
+WriteCallback JsonWriter::DescriptorCallback(int fd)
+{
+  return [fd](std::string_view data) {
+    // Short writes and interrupted calls are retried until everything is written
+    while (!data.empty())
+    {
+#ifdef _WIN32
+      auto written = _write(fd, data.data(), static_cast<unsigned int>(std::min<size_t>(data.size(), INT_MAX)));
+      if (written < 0) return false;
+#else
+      auto written = ::write(fd, data.data(), data.size());
+      if (written < 0 && errno == EINTR) continue;
+      if (written < 0) return false;
+#endif
+      data.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
+    };
+}
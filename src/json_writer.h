@@ -0,0 +1,73 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "json.h"
+#include "json_serializer.h"
+
+/*
+ * Emits JSON from application code without building a Json tree. Calls are
+ * chained, members are a Key() followed by a value and whole Json subtrees
+ * can be embedded as values. Output goes to a string or is streamed through
+ * a fixed-size buffer to a FILE*, a file descriptor or a callback.
+ */
+class JsonWriter {
+public:
+  explicit JsonWriter(std::string& output, const SerializeOptions& options = SerializeOptions());
+  explicit JsonWriter(FILE* file, const SerializeOptions& options = SerializeOptions());
+  explicit JsonWriter(int fd, const SerializeOptions& options = SerializeOptions());
+  explicit JsonWriter(const WriteCallback& callback, const SerializeOptions& options = SerializeOptions());
+
+  JsonWriter& StartObject();
+  JsonWriter& EndObject();
+  JsonWriter& StartArray();
+  JsonWriter& EndArray();
+  JsonWriter& Key(std::string_view key);
+
+  JsonWriter& Value(std::string_view value);
+  JsonWriter& Value(const char* value);
+  JsonWriter& Value(const Json& value);
+  JsonWriter& Null();
+
+  template<Arithmetic T>
+  JsonWriter& Value(T value);
+
+  /* Shorthand for Key(key).Value(value) */
+  template<typename T>
+  JsonWriter& Member(std::string_view key, T&& value);
+
+  /* Flushes buffered output, false when writing failed */
+  bool Finish();
+
+  /* Destinations used by the streaming constructors and Json::WriteTo */
+  static WriteCallback FileCallback(FILE* file);
+  static WriteCallback DescriptorCallback(int fd);
+
+private:
+  JsonSerializer serializer_;
+};
+
+
+template<Arithmetic T>
+JsonWriter& JsonWriter::Value(T value)
+{
+  if constexpr (std::is_same_v<T, bool>) serializer_.WriteBool(value);
+  else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) serializer_.WriteNumber(static_cast<Integer>(value));
+  else if constexpr (std::is_integral_v<T>) serializer_.WriteNumber(static_cast<Unsigned>(value));
+  else serializer_.WriteNumber(static_cast<Number>(value));
+
+  return *this;
+}
+
+template<typename T>
+JsonWriter& JsonWriter::Member(std::string_view key, T&& value)
+{
+  Key(key);
+  return Value(std::forward<T>(value));
+}
+
+#endif // !JSON_WRITER_H
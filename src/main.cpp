@@ -4,11 +4,11 @@
 
 int main()
 {
-  File my_file("testFiles/temp.txt");
+  File my_file("testFiles/temp.txt", File::Mode::Map);
 
   if (my_file.Load())
   {
-    auto ptr = Json::Parse(my_file.GetContent(), [](auto progress) {
+    auto ptr = Json::Parse(my_file.GetView(), [](auto progress) {
       std::cout << progress << std::endl;
       return progress < 40;
       });
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <system_error>
+
+#include "number_parser.h"
+
+// Any integer with that many digits fits into int64_t
+#define JSON_SAFE_INTEGER_DIGITS 18
+
+// Far past the decimal exponent range of double, also with any number of digits in the literal
+#define JSON_MAX_DECIMAL_EXPONENT 1000000000
+
+const char* NumberParser::Parse(const char* begin, const char* end, NumberValue& value)
+{
+  auto ch = begin;
+  bool negative = false;
+  bool integer = true;
+
+  if (ch != end && *ch == '-')
+  {
+    negative = true;
+    ch++;
+  }
+
+  // Integer part, leading zeros are not allowed
+  if (ch == end || !IsDigit(*ch)) return nullptr;
+
+  auto digits_begin = ch;
+  ch = *ch == '0' ? ch + 1 : SkipDigits(ch, end);
+  auto digits_count = ch - digits_begin;
+
+  // Fraction
+  if (ch != end && *ch == '.')
+  {
+    integer = false;
+    ch++;
+    if (ch == end || !IsDigit(*ch)) return nullptr;
+    ch = SkipDigits(ch, end);
+  }
+
+  // Exponent
+  if (ch != end && (*ch == 'e' || *ch == 'E'))
+  {
+    integer = false;
+    ch++;
+    if (ch != end && (*ch == '+' || *ch == '-')) ch++;
+    if (ch == end || !IsDigit(*ch)) return nullptr;
+    ch = SkipDigits(ch, end);
+  }
+
+  if (integer && digits_count <= JSON_SAFE_INTEGER_DIGITS)
+  {
+    uint64_t mantissa = 0;
+    for (auto digit = digits_begin; digit != ch; digit++)
+    {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*digit - '0');
+    }
+
+    // Integers have no negative zero, -0 stays a double to keep its sign
+    if (negative && mantissa == 0) value = -0.0;
+    else value = negative ? -static_cast<Integer>(mantissa) : static_cast<Integer>(mantissa);
+    return ch;
+  }
+
+  if (integer)
+  {
+    // Longer integers still may fit, from_chars reports the overflow
+    Integer signed_value = 0;
+    auto result = std::from_chars(begin, ch, signed_value);
+    if (result.ec == std::errc() && result.ptr == ch)
+    {
+      value = signed_value;
+      return ch;
+    }
+
+    Unsigned unsigned_value = 0;
+    result = std::from_chars(begin, ch, unsigned_value);
+    if (!negative && result.ec == std::errc() && result.ptr == ch)
+    {
+      value = unsigned_value;
+      return ch;
+    }
+  }
+
+  Number number = 0;
+  auto result = std::from_chars(begin, ch, number);
+  if (result.ptr != ch) return nullptr;
+
+  // The grammar is valid, so out of range means below the smallest subnormal or past the largest double
+  if (result.ec == std::errc::result_out_of_range)
+  {
+    if (!IsUnderflow(digits_begin, ch)) return nullptr;
+    number = negative ? -0.0 : 0.0;
+  }
+  else if (result.ec != std::errc())
+  {
+    return nullptr;
+  }
+
+  value = number;
+  return ch;
+}
+
+bool NumberParser::IsUnderflow(const char* digits, const char* end)
+{
+  // Decimal position of the first significant digit, the value is below one when it is negative
+  int64_t position = 0;
+  auto ch = digits;
+  bool significant = false;
+
+  for (; ch != end && IsDigit(*ch); ch++)
+  {
+    if (*ch != '0') significant = true;
+    if (significant) position++;
+  }
+
+  if (ch != end && *ch == '.')
+  {
+    for (ch++; ch != end && IsDigit(*ch) && !significant; ch++)
+    {
+      if (*ch == '0') position--;
+      else significant = true;
+    }
+
+    ch = SkipDigits(ch, end);
+  }
+
+  int64_t exponent = 0;
+  bool negative_exponent = false;
+
+  if (ch != end && (*ch == 'e' || *ch == 'E'))
+  {
+    ch++;
+    if (*ch == '+' || *ch == '-') negative_exponent = *ch++ == '-';
+
+    // Saturated, any exponent past the double range decides the same way
+    for (; ch != end && IsDigit(*ch); ch++) exponent = std::min<int64_t>(exponent * 10 + (*ch - '0'), JSON_MAX_DECIMAL_EXPONENT);
+  }
+
+  return position + (negative_exponent ? -exponent : exponent) < 0;
+}
+
+bool NumberParser::IsDigit(char ch)
+{
+  return ch >= '0' && ch <= '9';
+}
+
+const char* NumberParser::SkipDigits(const char* begin, const char* end)
+{
+  while (begin != end && IsDigit(*begin)) begin++;
+  return begin;
+}
@@ -0,0 +1,35 @@
+#ifndef NUMBER_PARSER_H
+#define NUMBER_PARSER_H
+
+#include <variant>
+
+#include "json.h"
+
+using NumberValue = std::variant<Number, Integer, Unsigned>;
+
+/*
+ * Validates and converts JSON numbers in place, without allocations and
+ * independently of the current locale.
+ *
+ * Grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ *
+ * Literals without fraction and exponent are kept as Integer, or Unsigned
+ * when they only fit into an unsigned 64-bit value; -0 is the exception and
+ * becomes a negative zero Number. Up to 18 digits they are
+ * accumulated in a plain loop, longer ones are range checked by
+ * std::from_chars. Everything else, and integers outside of both ranges,
+ * goes through std::from_chars as double.
+ * Numbers below the smallest subnormal become a zero with the sign of the
+ * literal, numbers past the largest double are rejected.
+ */
+class NumberParser {
+public:
+  static const char* Parse(const char* begin, const char* end, NumberValue& value);
+
+private:
+  static bool IsDigit(char ch);
+  static bool IsUnderflow(const char* digits, const char* end);
+  static const char* SkipDigits(const char* begin, const char* end);
+};
+
+#endif // !NUMBER_PARSER_H
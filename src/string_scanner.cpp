@@ -0,0 +1,223 @@
+#include <bit>
+#include <cstdint>
+
+#include "string_scanner.h"
+#include "cpu_features.h"
+
+#if JSON_ARCH_X86
+#include <immintrin.h>
+#endif
+
+const char* StringScanner::FindSpecial(const char* begin, const char* end)
+{
+  static const FindMethodType find_method = DetectFindMethod();
+  return find_method(begin, end);
+}
+
+bool StringScanner::Unescape(char escaped, char& decoded)
+{
+  switch (escaped)
+  {
+  case 'n':   decoded = '\n'; return true;
+  case 't':   decoded = '\t'; return true;
+  case 'f':   decoded = '\f'; return true;
+  case 'v':   decoded = '\v'; return true;
+  case 'b':   decoded = '\b'; return true;
+  case 'r':   decoded = '\r'; return true;
+  case '\\':  decoded = '\\'; return true;
+  case '\"':  decoded = '\"'; return true;
+  case '/':   decoded = '/'; return true;
+  case '\'':  decoded = '\''; return true;
+  case '\?':  decoded = '\?'; return true;
+  case '\a':  decoded = '\a'; return true;
+  default:    return false;
+  }
+}
+
+bool StringScanner::Unescape(std::string_view raw, std::string& str)
+{
+  auto ch = raw.data();
+  auto end = raw.data() + raw.size();
+
+  while (ch != end)
+  {
+    auto run_end = FindSpecial(ch, end);
+    str.append(ch, run_end);
+    ch = run_end;
+
+    if (ch == end) break;
+
+    if (*ch != '\\') str.append(1, *ch);
+    else if (++ch == end || !Unescape(ch, end, str)) return false;
+
+    ch++;
+  }
+
+  return true;
+}
+
+bool StringScanner::Unescape(const char*& ch, const char* end, std::string& str)
+{
+  char decoded;
+  if (Unescape(*ch, decoded))
+  {
+    str.append(1, decoded);
+    return true;
+  }
+
+  uint32_t code_point;
+  if (!ReadCodePoint(ch, end, code_point)) return false;
+
+  AppendUtf8(code_point, str);
+  return true;
+}
+
+bool StringScanner::SkipEscape(const char*& ch, const char* end)
+{
+  char decoded;
+  uint32_t code_point;
+
+  return Unescape(*ch, decoded) || ReadCodePoint(ch, end, code_point);
+}
+
+bool StringScanner::ReadCodePoint(const char*& ch, const char* end, uint32_t& code_point)
+{
+  if (*ch != 'u' || end - ch < 5 || !ReadHex(ch + 1, code_point)) return false;
+  ch += 4;
+
+  if (code_point < 0xD800 || code_point > 0xDFFF) return true;
+  if (code_point > 0xDBFF) return false;
+
+  // The low surrogate follows as the next escape
+  uint32_t low;
+  if (end - ch < 7 || ch[1] != '\\' || ch[2] != 'u' || !ReadHex(ch + 3, low) || low < 0xDC00 || low > 0xDFFF) return false;
+  ch += 6;
+
+  code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+  return true;
+}
+
+bool StringScanner::ReadHex(const char* ch, uint32_t& value)
+{
+  value = 0;
+
+  for (int i = 0; i < 4; i++)
+  {
+    auto digit = ch[i];
+    value <<= 4;
+
+    if (digit >= '0' && digit <= '9') value |= digit - '0';
+    else if (digit >= 'a' && digit <= 'f') value |= digit - 'a' + 10;
+    else if (digit >= 'A' && digit <= 'F') value |= digit - 'A' + 10;
+    else return false;
+  }
+
+  return true;
+}
+
+void StringScanner::AppendUtf8(uint32_t code_point, std::string& str)
+{
+  if (code_point < 0x80)
+  {
+    str.append(1, static_cast<char>(code_point));
+  }
+  else if (code_point < 0x800)
+  {
+    str.append(1, static_cast<char>(0xC0 | (code_point >> 6)));
+    str.append(1, static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+  else if (code_point < 0x10000)
+  {
+    str.append(1, static_cast<char>(0xE0 | (code_point >> 12)));
+    str.append(1, static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    str.append(1, static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+  else
+  {
+    str.append(1, static_cast<char>(0xF0 | (code_point >> 18)));
+    str.append(1, static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    str.append(1, static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    str.append(1, static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+bool StringScanner::IsSpecial(char ch)
+{
+  return ch == '\"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20;
+}
+
+const char* StringScanner::FindSpecialScalar(const char* begin, const char* end)
+{
+  while (begin != end && !IsSpecial(*begin)) begin++;
+  return begin;
+}
+
+#if JSON_ARCH_X86
+
+JSON_TARGET_SSE42 const char* StringScanner::FindSpecialSse42(const char* begin, const char* end)
+{
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+
+  while (end - begin >= 16)
+  {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+    // Unsigned min keeps only bytes not greater than 0x1F equal to themselves
+    auto special = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+      _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+
+    auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+    if (mask != 0) return begin + std::countr_zero(mask);
+
+    begin += 16;
+  }
+
+  return FindSpecialScalar(begin, end);
+}
+
+JSON_TARGET_AVX2 const char* StringScanner::FindSpecialAvx2(const char* begin, const char* end)
+{
+  const __m256i quote = _mm256_set1_epi8('\"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i control = _mm256_set1_epi8(0x1F);
+
+  while (end - begin >= 32)
+  {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+    auto special = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+      _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk));
+
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+    if (mask != 0) return begin + std::countr_zero(mask);
+
+    begin += 32;
+  }
+
+  return FindSpecialSse42(begin, end);
+}
+
+#else
+
+const char* StringScanner::FindSpecialSse42(const char* begin, const char* end)
+{
+  return FindSpecialScalar(begin, end);
+}
+
+const char* StringScanner::FindSpecialAvx2(const char* begin, const char* end)
+{
+  return FindSpecialScalar(begin, end);
+}
+
+#endif
+
+StringScanner::FindMethodType StringScanner::DetectFindMethod()
+{
+  if (CpuFeatures::HasAvx2()) return &StringScanner::FindSpecialAvx2;
+  if (CpuFeatures::HasSse42()) return &StringScanner::FindSpecialSse42;
+  return &StringScanner::FindSpecialScalar;
+}
@@ -0,0 +1,41 @@
+#ifndef STRING_SCANNER_H
+#define STRING_SCANNER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * Finds characters that end a plain run inside of a JSON string: quotes,
+ * backslashes and control characters. Runs are scanned 32 (AVX2) or
+ * 16 (SSE4.2) bytes at a time, with a scalar loop for the remainder.
+ */
+class StringScanner {
+public:
+  using FindMethodType = const char* (*)(const char*, const char*);
+
+  static const char* FindSpecial(const char* begin, const char* end);
+
+  /* Escape sequences, shared by the parser and lazily decoded strings */
+  static bool Unescape(char escaped, char& decoded);
+  static bool Unescape(std::string_view raw, std::string& str);
+
+  /* Escape at ch, just after the backslash; ch is left at its last character. \u escapes are written as UTF-8 */
+  static bool Unescape(const char*& ch, const char* end, std::string& str);
+  static bool SkipEscape(const char*& ch, const char* end);
+
+private:
+  static bool IsSpecial(char ch);
+
+  /* \uXXXX escapes, surrogates only as a high and low pair */
+  static bool ReadCodePoint(const char*& ch, const char* end, uint32_t& code_point);
+  static bool ReadHex(const char* ch, uint32_t& value);
+  static void AppendUtf8(uint32_t code_point, std::string& str);
+
+  static const char* FindSpecialScalar(const char* begin, const char* end);
+  static const char* FindSpecialSse42(const char* begin, const char* end);
+  static const char* FindSpecialAvx2(const char* begin, const char* end);
+  static FindMethodType DetectFindMethod();
+};
+
+#endif // !STRING_SCANNER_H
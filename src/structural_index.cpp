@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "structural_index.h"
+#include "cpu_features.h"
+
+#if JSON_ARCH_X86
+#include <immintrin.h>
+#endif
+
+#define JSON_BLOCK_SIZE 64
+
+StructuralIndex::StructuralIndex()
+  : implementation_{ DetectImplementation() }
+  , prev_escaped_{ 0 }
+  , prev_in_string_{ 0 }
+  , prev_scalar_{ 0 }
+{
+}
+
+bool StructuralIndex::Build(std::string_view data)
+{
+  return Build(data, DetectImplementation());
+}
+
+bool StructuralIndex::Build(std::string_view data, Implementation implementation)
+{
+  Clear();
+
+  // Positions are stored as 32-bit offsets
+  if (data.size() > std::numeric_limits<uint32_t>::max()) return false;
+
+  // Never run an instruction set the CPU does not have
+  implementation_ = std::min(implementation, DetectImplementation());
+
+  auto classify = &StructuralIndex::ClassifyScalar;
+  if (implementation_ == Implementation::Sse42) classify = &StructuralIndex::ClassifySse42;
+  if (implementation_ == Implementation::Avx2) classify = &StructuralIndex::ClassifyAvx2;
+
+  positions_.reserve(data.size() / 8);
+
+  size_t offset = 0;
+  for (; offset + JSON_BLOCK_SIZE <= data.size(); offset += JSON_BLOCK_SIZE)
+  {
+    ProcessBlock(classify(data.data() + offset), offset);
+  }
+
+  if (offset < data.size())
+  {
+    // Pad the last block with whitespaces, they never produce a token
+    char block[JSON_BLOCK_SIZE];
+    std::memset(block, ' ', JSON_BLOCK_SIZE);
+    std::memcpy(block, data.data() + offset, data.size() - offset);
+    ProcessBlock(classify(block), offset);
+  }
+
+  // Input ending inside of a string cannot be indexed
+  return prev_in_string_ == 0;
+}
+
+void StructuralIndex::Clear()
+{
+  positions_.clear();
+  prev_escaped_ = 0;
+  prev_in_string_ = 0;
+  prev_scalar_ = 0;
+}
+
+const std::vector<uint32_t>& StructuralIndex::GetPositions() const
+{
+  return positions_;
+}
+
+StructuralIndex::Implementation StructuralIndex::GetImplementation() const
+{
+  return implementation_;
+}
+
+StructuralIndex::Implementation StructuralIndex::DetectImplementation()
+{
+  if (CpuFeatures::HasAvx2()) return Implementation::Avx2;
+  if (CpuFeatures::HasSse42()) return Implementation::Sse42;
+  return Implementation::Scalar;
+}
+
+StructuralIndex::BlockMasks StructuralIndex::ClassifyScalar(const char* block)
+{
+  BlockMasks masks{ 0, 0, 0, 0 };
+
+  for (int i = 0; i < JSON_BLOCK_SIZE; i++)
+  {
+    auto bit = uint64_t(1) << i;
+
+    switch (block[i])
+    {
+    case '\"':
+      masks.quote |= bit;
+      break;
+
+    case '\\':
+      masks.backslash |= bit;
+      break;
+
+    case '\n':
+    case '\f':
+    case '\r':
+    case '\t':
+    case '\v':
+    case ' ':
+      masks.whitespace |= bit;
+      break;
+
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      masks.op |= bit;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return masks;
+}
+
+#if JSON_ARCH_X86
+
+JSON_TARGET_SSE42 StructuralIndex::BlockMasks StructuralIndex::ClassifySse42(const char* block)
+{
+  constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+
+  const __m128i ops = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i spaces = _mm_setr_epi8(' ', '\t', '\n', '\r', '\f', '\v', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+
+  BlockMasks masks{ 0, 0, 0, 0 };
+
+  for (int i = 0; i < JSON_BLOCK_SIZE / 16; i++)
+  {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    auto shift = 16 * i;
+
+    auto quote_bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+    auto backslash_bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)));
+    auto op_bits = static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_cmpestrm(ops, 6, chunk, 16, mode)));
+    auto space_bits = static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_cmpestrm(spaces, 6, chunk, 16, mode)));
+
+    masks.quote |= uint64_t(quote_bits) << shift;
+    masks.backslash |= uint64_t(backslash_bits) << shift;
+    masks.op |= uint64_t(op_bits) << shift;
+    masks.whitespace |= uint64_t(space_bits) << shift;
+  }
+
+  return masks;
+}
+
+JSON_TARGET_AVX2 static inline __m256i EqualsAvx2(__m256i chunk, char c)
+{
+  return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c));
+}
+
+JSON_TARGET_AVX2 StructuralIndex::BlockMasks StructuralIndex::ClassifyAvx2(const char* block)
+{
+  BlockMasks masks{ 0, 0, 0, 0 };
+
+  for (int i = 0; i < JSON_BLOCK_SIZE / 32; i++)
+  {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+    auto shift = 32 * i;
+
+    auto op = _mm256_or_si256(
+      _mm256_or_si256(_mm256_or_si256(EqualsAvx2(chunk, '{'), EqualsAvx2(chunk, '}')), _mm256_or_si256(EqualsAvx2(chunk, '['), EqualsAvx2(chunk, ']'))),
+      _mm256_or_si256(EqualsAvx2(chunk, ':'), EqualsAvx2(chunk, ',')));
+
+    auto space = _mm256_or_si256(
+      _mm256_or_si256(_mm256_or_si256(EqualsAvx2(chunk, ' '), EqualsAvx2(chunk, '\t')), _mm256_or_si256(EqualsAvx2(chunk, '\n'), EqualsAvx2(chunk, '\r'))),
+      _mm256_or_si256(EqualsAvx2(chunk, '\f'), EqualsAvx2(chunk, '\v')));
+
+    masks.quote |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(EqualsAvx2(chunk, '\"')))) << shift;
+    masks.backslash |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(EqualsAvx2(chunk, '\\')))) << shift;
+    masks.op |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << shift;
+    masks.whitespace |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(space))) << shift;
+  }
+
+  return masks;
+}
+
+#else
+
+StructuralIndex::BlockMasks StructuralIndex::ClassifySse42(const char* block)
+{
+  return ClassifyScalar(block);
+}
+
+StructuralIndex::BlockMasks StructuralIndex::ClassifyAvx2(const char* block)
+{
+  return ClassifyScalar(block);
+}
+
+#endif
+
+uint64_t StructuralIndex::FindEscaped(uint64_t backslash)
+{
+  constexpr uint64_t even_bits = 0x5555555555555555ULL;
+
+  // Character escaped by the end of the previous block cannot start a new escape
+  backslash &= ~prev_escaped_;
+  uint64_t follows_escape = (backslash << 1) | prev_escaped_;
+
+  // Sequences of backslashes starting on odd bits are cleared out by the carry of the addition
+  uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+  prev_escaped_ = sequences_starting_on_even_bits < odd_sequence_starts ? 1 : 0;
+
+  uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+void StructuralIndex::ProcessBlock(const BlockMasks& masks, size_t offset)
+{
+  auto quote = masks.quote & ~FindEscaped(masks.backslash);
+
+  // Prefix xor marks everything from an opening quote up to the closing one
+  auto in_string = quote;
+  in_string ^= in_string << 1;
+  in_string ^= in_string << 2;
+  in_string ^= in_string << 4;
+  in_string ^= in_string << 8;
+  in_string ^= in_string << 16;
+  in_string ^= in_string << 32;
+  in_string ^= prev_in_string_;
+  prev_in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+  auto outside = ~(in_string | quote);
+  auto scalar = ~(masks.op | masks.whitespace) & outside;
+  auto scalar_start = scalar & ~((scalar << 1) | prev_scalar_);
+  prev_scalar_ = scalar >> 63;
+
+  auto tokens = (masks.op & outside) | (quote & in_string) | scalar_start;
+
+  while (tokens != 0)
+  {
+    positions_.push_back(static_cast<uint32_t>(offset + std::countr_zero(tokens)));
+    tokens &= tokens - 1;
+  }
+}
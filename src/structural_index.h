@@ -0,0 +1,58 @@
+#ifndef STRUCTURAL_INDEX_H
+#define STRUCTURAL_INDEX_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+ * Stage 1 of the parallel parser. The input is classified in 64-byte blocks
+ * into quotes, backslashes, whitespaces and operators, string contents are
+ * masked out and the positions of all tokens (operators, opening quotes and
+ * first characters of literals and numbers) are recorded. The split into
+ * tasks walks these positions instead of the input.
+ */
+class StructuralIndex {
+public:
+  enum class Implementation {
+    Scalar,
+    Sse42,
+    Avx2,
+  };
+
+  StructuralIndex();
+
+  bool Build(std::string_view data);
+  bool Build(std::string_view data, Implementation implementation);
+  void Clear();
+
+  const std::vector<uint32_t>& GetPositions() const;
+  Implementation GetImplementation() const;
+
+  static Implementation DetectImplementation();
+
+private:
+  struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t whitespace;
+    uint64_t op;
+  };
+
+  static BlockMasks ClassifyScalar(const char* block);
+  static BlockMasks ClassifySse42(const char* block);
+  static BlockMasks ClassifyAvx2(const char* block);
+
+  uint64_t FindEscaped(uint64_t backslash);
+  void ProcessBlock(const BlockMasks& masks, size_t offset);
+
+  std::vector<uint32_t> positions_;
+  Implementation implementation_;
+
+  // State carried between blocks
+  uint64_t prev_escaped_;
+  uint64_t prev_in_string_;
+  uint64_t prev_scalar_;
+};
+
+#endif // !STRUCTURAL_INDEX_H
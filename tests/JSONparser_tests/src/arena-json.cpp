@@ -0,0 +1,109 @@
+#include "arena-json.h"
+
+TEST_F(ArenaTests, HeapDocumentHasNoArena) {
+  auto json = Json::Parse(R"({ "key" : "value" })");
+
+  EXPECT_EQ(json->GetArena(), nullptr);
+}
+
+TEST_F(ArenaTests, ObjectWithNestedArrays) {
+  auto json = Json::Parse(R"({ "key1" : ["value1", 3.14, [{ "key" : "value"}, true]]})", arena_options_);
+
+  ASSERT_NE(json->GetArena(), nullptr);
+  EXPECT_EQ(json->GetType(), Json::ValueType::Object);
+  EXPECT_EQ(json->GetParent(), nullptr);
+
+  auto child_element = (*json)["key1"];
+  ASSERT_NE(child_element, nullptr);
+  EXPECT_EQ(child_element->GetArena(), json->GetArena());
+  EXPECT_EQ(child_element->GetParent(), json.get());
+  EXPECT_EQ(child_element->GetType(), Json::ValueType::Array);
+
+  auto& array_values = std::get<ChildrenList>(child_element->GetValue());
+  ASSERT_EQ(array_values.size(), 3);
+  EXPECT_EQ(std::get<String>(array_values.at(0)->GetValue()), "value1");
+  EXPECT_EQ(std::get<Number>(array_values.at(1)->GetValue()), 3.14);
+
+  auto nested = (*array_values.at(2))[0];
+  ASSERT_NE(nested, nullptr);
+  EXPECT_EQ(nested->GetParent(), array_values.at(2).get());
+  EXPECT_EQ(std::get<String>((*nested)["key"]->GetValue()), "value");
+}
+
+TEST_F(ArenaTests, NodesAreAllocatedFromChunks) {
+  std::string data = "[";
+  for (int i = 0; i < 1000; i++)
+  {
+    data += R"({ "a long key that does not fit in place" : "a long value that does not fit in place" },)";
+  }
+  data += "{}]";
+
+  auto json = Json::Parse(data, arena_options_);
+  auto arena = json->GetArena();
+
+  ASSERT_NE(arena, nullptr);
+  EXPECT_EQ(std::get<ChildrenList>(json->GetValue()).size(), 1001);
+  EXPECT_GT(arena->GetAllocatedBytes(), 1000 * sizeof(Json));
+  EXPECT_LE(arena->GetAllocatedBytes(), arena->GetReservedBytes());
+  EXPECT_LT(arena->GetChunkCount(), 16);
+}
+
+TEST_F(ArenaTests, AddedChildrenShareTheArena) {
+  auto json = Json::Parse(R"({ "key" : {} })", arena_options_);
+
+  auto child = json->AddChild("value", "added");
+  ASSERT_NE(child, nullptr);
+  EXPECT_EQ(child->GetArena(), json->GetArena());
+  EXPECT_EQ(std::get<String>(child->GetValue()), "value");
+}
+
+TEST_F(ArenaTests, DetachReturnsHeapCopy) {
+  auto json = Json::Parse(R"({ "key" : { "nested" : true } })", arena_options_);
+
+  auto detached = (*json)["key"]->Detach();
+  ASSERT_NE(detached, nullptr);
+  EXPECT_EQ(detached->GetArena(), nullptr);
+  EXPECT_EQ((*json)["key"], nullptr);
+
+  json.reset();
+  EXPECT_EQ(detached->GetKey(), "key");
+  EXPECT_EQ(std::get<Bool>((*detached)["nested"]->GetValue()), true);
+}
+
+TEST_F(ArenaTests, CopyIsHeapDocument) {
+  auto json = Json::Parse(R"({ "key" : [1, 2, 3] })", arena_options_);
+
+  Json copy(*json);
+  json.reset();
+
+  EXPECT_EQ(copy.GetArena(), nullptr);
+  EXPECT_EQ(std::get<ChildrenList>(copy["key"]->GetValue()).size(), 3);
+}
+
+TEST_F(ArenaTests, MoveAssignedRootTakesTheArena) {
+  Json target;
+  {
+    auto source = Json::Parse(R"({ "key" : ["a long value that does not fit in place", 1] })", arena_options_);
+    auto arena = source->GetArena();
+
+    target = std::move(*source);
+    EXPECT_EQ(target.GetArena(), arena);
+  }
+
+  EXPECT_EQ(target.ToString(), R"({"key":["a long value that does not fit in place",1]})");
+  EXPECT_EQ(target["key"]->GetParent(), &target);
+}
+
+TEST_F(ArenaTests, MoveAssignedMemberIsCopied) {
+  Json target;
+  {
+    auto source = Json::Parse(R"({ "key" : { "nested" : "a long value that does not fit in place" } })", arena_options_);
+    target = std::move(*(*source)["key"]);
+
+    // The target takes over the parent of the member, which is about to go away
+    target.SetParent(nullptr);
+  }
+
+  EXPECT_EQ(target.GetArena(), nullptr);
+  EXPECT_EQ(target.ToString(), R"({"nested":"a long value that does not fit in place"})");
+}
@@ -0,0 +1,8 @@
+#include <gtest/gtest.h>
+#include "json.h"
+
+class ArenaTests : public testing::Test
+{
+protected:
+  ParseOptions arena_options_{ .use_arena = true };
+};
@@ -0,0 +1,91 @@
+#include "compact-json.h"
+
+TEST_F(CompactTests, NodeSizeBudget) {
+  EXPECT_EQ(sizeof(JsonCompact::Node), 16);
+}
+
+TEST_F(CompactTests, ObjectWithValidElements) {
+  auto document = JsonCompact::Parse(R"({ "string" : "va\"lue", "number" : 13.4, "integer" : -7, "big" : 18446744073709551615,
+    "true" : true, "false" : false, "null" : null })");
+
+  ASSERT_TRUE(document->IsValid());
+  auto root = document->GetRoot();
+  EXPECT_EQ(root.GetType(), Json::ValueType::Object);
+  EXPECT_EQ(root.Size(), 7);
+
+  EXPECT_EQ(root["string"].GetKey(), "string");
+  EXPECT_EQ(root["string"].GetString(), "va\"lue");
+  EXPECT_EQ(root["number"].GetNumber(), 13.4);
+  EXPECT_TRUE(root["integer"].IsInteger());
+  EXPECT_EQ(root["integer"].GetInt64(), -7);
+  EXPECT_EQ(root["big"].GetUInt64(), 18446744073709551615ull);
+  EXPECT_TRUE(root["true"].GetBool());
+  EXPECT_FALSE(root["false"].GetBool());
+  EXPECT_EQ(root["null"].GetType(), Json::ValueType::Null);
+  EXPECT_FALSE(root["missing"].IsValid());
+}
+
+TEST_F(CompactTests, NestedContainers) {
+  std::string data = R"({"a":[1,{"b":[true,[]],"c":{}},"x"],"d":{"e":null},"f":[]})";
+  auto document = JsonCompact::Parse(data);
+
+  ASSERT_TRUE(document->IsValid());
+  EXPECT_EQ(document->ToString(), JsonTape::Parse(data)->ToString());
+
+  auto root = document->GetRoot();
+  EXPECT_EQ(root["a"].Size(), 3);
+  EXPECT_TRUE(root["a"][1]["b"][0].GetBool());
+  EXPECT_TRUE(root["a"][1].IsArrayElement());
+  EXPECT_EQ(root["a"][1]["b"][1].Size(), 0);
+  EXPECT_EQ(root["a"][2].GetString(), "x");
+  EXPECT_FALSE(root["a"][3].IsValid());
+  EXPECT_EQ(root["d"]["e"].GetType(), Json::ValueType::Null);
+  EXPECT_EQ(root["f"].GetType(), Json::ValueType::Array);
+}
+
+TEST_F(CompactTests, ScalarRoot) {
+  auto document = JsonCompact::Parse(" 42 ");
+
+  ASSERT_TRUE(document->IsValid());
+  EXPECT_EQ(document->GetNodeCount(), 1);
+  EXPECT_EQ(document->GetRoot().GetInt64(), 42);
+  EXPECT_FALSE(document->GetRoot().IsArrayElement());
+}
+
+TEST_F(CompactTests, SiblingsAreContiguous) {
+  auto document = JsonCompact::Parse(R"([{"id":1,"tag":"a"},{"id":2,"tag":"b"},{"id":3,"tag":"c"}])");
+
+  ASSERT_TRUE(document->IsValid());
+  EXPECT_EQ(document->GetNodeCount(), 10);
+
+  auto root = document->GetRoot();
+  for (int i = 0; i < 3; i++)
+  {
+    EXPECT_EQ(root[i]["id"].GetInt64(), i + 1);
+    EXPECT_EQ(root[i]["tag"].GetKey().data(), root[0]["tag"].GetKey().data());
+  }
+}
+
+TEST_F(CompactTests, FindAllIfInDocumentOrder) {
+  auto document = JsonCompact::Parse(R"({"a":1,"b":[2,{"c":3}],"d":"4","e":5})");
+  ASSERT_TRUE(document->IsValid());
+
+  auto numbers = document->FindAllIf([](const JsonCompact::Element& element) {
+    return element.GetType() == Json::ValueType::Number;
+    });
+
+  ASSERT_EQ(numbers.size(), 4);
+  for (size_t i = 0; i < numbers.size(); i++)
+  {
+    EXPECT_EQ(numbers[i].GetInt64(), i < 3 ? i + 1 : 5);
+  }
+}
+
+TEST_F(CompactTests, InvalidDocuments) {
+  for (auto data : { R"({"key": })", R"([1,])", R"([1 2])", R"({"a":tru})", R"([1] [])", "" })
+  {
+    auto document = JsonCompact::Parse(data);
+    EXPECT_FALSE(document->IsValid()) << data;
+    EXPECT_FALSE(document->GetRoot().IsValid()) << data;
+  }
+}
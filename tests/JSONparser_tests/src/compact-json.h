@@ -0,0 +1,9 @@
+#include <gtest/gtest.h>
+#include "json_compact.h"
+#include "json_tape.h"
+
+class CompactTests : public testing::Test
+{
+protected:
+
+};
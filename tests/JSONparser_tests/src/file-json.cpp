@@ -0,0 +1,30 @@
+#include "file-json.h"
+
+TEST_F(FileTests, ReadMode) {
+  File file(path_.c_str());
+
+  ASSERT_TRUE(file.Load());
+  EXPECT_EQ(file.size(), content_.size());
+  EXPECT_EQ(file.GetContent(), content_);
+  EXPECT_EQ(file.GetView(), content_);
+}
+
+TEST_F(FileTests, MapMode) {
+  File file(path_.c_str(), File::Mode::Map);
+
+  ASSERT_TRUE(file.Load());
+  EXPECT_EQ(file.size(), content_.size());
+  EXPECT_TRUE(file.GetContent().empty());
+  EXPECT_EQ(file.GetView(), content_);
+
+  auto json = Json::Parse(file.GetView());
+  ASSERT_EQ(json->GetType(), Json::ValueType::Object);
+  EXPECT_EQ(std::get<String>((*json)["name"]->GetValue()), std::string_view("mapped"));
+}
+
+TEST_F(FileTests, MissingFile) {
+  File file((path_ + ".missing").c_str(), File::Mode::Map);
+
+  EXPECT_FALSE(file.Load());
+  EXPECT_TRUE(file.GetView().empty());
+}
@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+#include "file.h"
+#include "json.h"
+
+class FileTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path_ = testing::TempDir() + "file-json-test.json";
+    auto file = fopen(path_.c_str(), "wb");
+    fwrite(content_.data(), 1, content_.size(), file);
+    fclose(file);
+  }
+
+  void TearDown() override
+  {
+    remove(path_.c_str());
+  }
+
+  std::string path_;
+  std::string content_ = R"({"name":"mapped","values":[1,2,3]})";
+};
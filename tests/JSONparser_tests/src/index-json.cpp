@@ -0,0 +1,50 @@
+#include "index-json.h"
+
+TEST_F(StructuralIndexTests, TokenPositions) {
+  StructuralIndex index;
+  ASSERT_TRUE(index.Build(R"({ "a:b" : [12, true], "c" : "{\"}" })"));
+
+  std::vector<uint32_t> expected = { 0, 2, 8, 10, 11, 13, 15, 19, 20, 22, 26, 28, 35 };
+  EXPECT_EQ(index.GetPositions(), expected);
+}
+
+TEST_F(StructuralIndexTests, UnterminatedString) {
+  StructuralIndex index;
+  EXPECT_FALSE(index.Build(R"({ "key" : "value })"));
+}
+
+TEST_F(StructuralIndexTests, ImplementationsAgree) {
+  // Escapes and strings crossing the 64-byte block boundaries
+  std::string data = "[";
+  for (int i = 0; i < 200; i++)
+  {
+    data += "\"" + std::string(i % 70, 'x') + std::string(i % 5, '\\') + (i % 5 % 2 ? "\\\"" : "") + "\", " + std::to_string(i) + ",";
+  }
+  data += "{}]";
+
+  auto scalar = BuildPositions(data, StructuralIndex::Implementation::Scalar);
+  EXPECT_EQ(BuildPositions(data, StructuralIndex::Implementation::Sse42), scalar);
+  EXPECT_EQ(BuildPositions(data, StructuralIndex::Implementation::Avx2), scalar);
+}
+
+TEST_F(StructuralIndexTests, PrettyParseMatchesCompact) {
+  std::string compact = "[";
+  std::string pretty = "[\n";
+  for (int i = 0; i < 200; i++)
+  {
+    compact += R"({"id":"item","tags":["a","b c"],"flag":true,"nested":{"empty":[]}},)";
+    pretty += "  {\n    \"id\" : \"item\",\n    \"tags\" : [ \"a\", \"b c\" ],\n    \"flag\" : true,\n    \"nested\" : {\n      \"empty\" : [ ]\n    }\n  },\n";
+  }
+  compact += "null]";
+  pretty += "  null\n]\n";
+
+  ASSERT_GE(pretty.size(), 4096);
+
+  auto json = Json::Parse(pretty);
+  EXPECT_EQ(std::get<ChildrenList>(json->GetValue()).size(), 201);
+  EXPECT_EQ(json->ToString(), Json::Parse(compact)->ToString());
+
+  auto tape = JsonTape::Parse(pretty);
+  ASSERT_TRUE(tape->IsValid());
+  EXPECT_EQ(tape->ToString(), compact);
+}
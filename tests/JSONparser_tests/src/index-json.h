@@ -0,0 +1,15 @@
+#include <gtest/gtest.h>
+#include "json.h"
+#include "json_tape.h"
+#include "structural_index.h"
+
+class StructuralIndexTests : public testing::Test
+{
+protected:
+  std::vector<uint32_t> BuildPositions(std::string_view data, StructuralIndex::Implementation implementation)
+  {
+    StructuralIndex index;
+    index.Build(data, implementation);
+    return index.GetPositions();
+  }
+};
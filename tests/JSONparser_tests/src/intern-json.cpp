@@ -0,0 +1,109 @@
+#include "intern-json.h"
+
+TEST_F(InternTests, KeysAreSharedByNodes) {
+  auto json = Json::Parse(data_, intern_options_);
+
+  ExpectSharedKeys(*json);
+  EXPECT_EQ(json->GetStringPool()->GetCount(), 3);
+  EXPECT_EQ(json->ToString(), Json::Parse(data_)->ToString());
+
+  auto element = (*json)[42];
+  EXPECT_EQ((*element)["id"]->GetInt64(), 42);
+  EXPECT_EQ((*element)["status"]->GetKey(), "status");
+}
+
+TEST_F(InternTests, DocumentsWithoutPool) {
+  auto json = Json::Parse(data_);
+
+  EXPECT_EQ(json->GetStringPool(), nullptr);
+  EXPECT_NE((*(*json)[0])["status"]->GetKey().data(), (*(*json)[1])["status"]->GetKey().data());
+}
+
+TEST_F(InternTests, EveryParserInterns) {
+  ExpectSharedKeys(*Json::Parse(data_, ParseOptions{ .use_arena = true, .intern_keys = true }));
+
+  JsonParser parser;
+  parser.Start(intern_options_);
+  ASSERT_TRUE(parser.Feed(data_));
+  ExpectSharedKeys(*parser.Finish());
+
+  // Keys interned by the tasks end up in the pool of the document
+  ThreadPool pool(2);
+  JsonParallelParser parallel(pool, intern_options_);
+  auto json = parallel.Parse(data_);
+  ExpectSharedKeys(*json);
+  EXPECT_EQ(json->ToString(), Json::Parse(data_)->ToString());
+  EXPECT_EQ(json->GetStringPool()->GetCount(), 3);
+}
+
+TEST_F(InternTests, SetKeyOnInternedNode) {
+  auto json = Json::Parse(data_, intern_options_);
+  auto first = (*(*json)[0])["status"];
+  auto second = (*(*json)[1])["status"];
+
+  EXPECT_FALSE(first->SetKey("id"));
+  EXPECT_TRUE(first->SetKey("state"));
+  EXPECT_EQ(first->GetKey(), "state");
+  EXPECT_EQ(second->GetKey(), "status");
+}
+
+TEST_F(InternTests, DetachedNodesOutliveDocument) {
+  std::unique_ptr<Json> detached;
+  {
+    auto json = Json::Parse(data_, intern_options_);
+    detached = (*json)[7]->Detach();
+  }
+
+  ASSERT_NE(detached, nullptr);
+  EXPECT_EQ(detached->GetStringPool(), nullptr);
+  EXPECT_EQ((*detached)["id"]->GetInt64(), 7);
+  EXPECT_EQ((*detached)["a key longer than the small buffer"]->GetKey(), "a key longer than the small buffer");
+}
+
+TEST_F(InternTests, MovedMembersOutliveDocument) {
+  Json assigned;
+  std::unique_ptr<Json> constructed;
+  {
+    auto json = Json::Parse(data_, intern_options_);
+    assigned = std::move(*(*(*json)[3])["status"]);
+    constructed = std::make_unique<Json>(std::move(*(*json)[5]));
+  }
+
+  EXPECT_EQ(assigned.GetKey(), "status");
+  EXPECT_EQ(std::get<String>(assigned.GetValue()), "ok");
+  EXPECT_EQ((*constructed)["id"]->GetInt64(), 5);
+  EXPECT_EQ((*constructed)["a key longer than the small buffer"]->GetKey(), "a key longer than the small buffer");
+}
+
+TEST_F(InternTests, LookupsCompareInternedKeys) {
+  std::string data = "{";
+  for (int i = 0; i < 64; i++) data += "\"member " + std::to_string(i) + "\":" + std::to_string(i) + ",";
+  data += R"("small":{"a":1,"b":2}})";
+
+  auto json = Json::Parse(data, intern_options_);
+
+  // Large objects go through the key index, small ones are scanned
+  EXPECT_EQ((*json)["member 40"]->GetInt64(), 40);
+  EXPECT_EQ((*(*json)["small"])["b"]->GetInt64(), 2);
+  EXPECT_EQ((*json)["not a member"], nullptr);
+
+  // Keys set later are not interned and are still found
+  auto small = (*json)["small"];
+  EXPECT_TRUE((*small)["a"]->SetKey("renamed"));
+  small->AddChild(3, "added");
+  EXPECT_EQ((*small)["renamed"]->GetInt64(), 1);
+  EXPECT_EQ((*small)["added"]->GetInt64(), 3);
+  EXPECT_EQ((*small)["a"], nullptr);
+}
+
+TEST_F(InternTests, MovedDocumentKeysUseTheTargetPool) {
+  auto target = Json::Parse(R"({"status":"target"})", intern_options_);
+  {
+    auto source = Json::Parse(data_, intern_options_);
+    *target = std::move(*source);
+  }
+
+  ExpectSharedKeys(*target);
+  EXPECT_EQ((*(*target)[9])["status"]->GetKey().data(), target->GetStringPool()->Find("status")->data());
+  EXPECT_EQ((*(*target)[9])["id"]->GetInt64(), 9);
+}
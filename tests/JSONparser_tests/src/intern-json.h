@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "json.h"
+#include "json_parser.h"
+#include "json_parallel.h"
+
+class InternTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    data_ = "[";
+    for (int i = 0; i < 100; i++)
+    {
+      data_ += R"({"id":)" + std::to_string(i) + R"(,"status":"ok","a key longer than the small buffer":true},)";
+    }
+    data_.back() = ']';
+  }
+
+  static void ExpectSharedKeys(const Json& json)
+  {
+    ASSERT_EQ(json.GetType(), Json::ValueType::Array);
+    ASSERT_NE(json.GetStringPool(), nullptr);
+
+    auto& elements = std::get<ChildrenList>(json.GetValue());
+    ASSERT_EQ(elements.size(), 100);
+
+    auto& first = std::get<ChildrenList>(elements.front()->GetValue());
+    auto& last = std::get<ChildrenList>(elements.back()->GetValue());
+    for (size_t i = 0; i < first.size(); i++)
+    {
+      EXPECT_EQ(first[i]->GetKey().data(), last[i]->GetKey().data());
+    }
+  }
+
+  ParseOptions intern_options_{ .intern_keys = true };
+  std::string data_;
+};
@@ -0,0 +1,96 @@
+#include "keys-json.h"
+
+TEST_F(KeyIndexTests, LookupFindsEveryMember) {
+  for (int i = 0; i < kMembers; i++)
+  {
+    auto member = object_["key" + std::to_string(i)];
+    ASSERT_NE(member, nullptr);
+    EXPECT_EQ(member->GetInt64(), i);
+  }
+
+  EXPECT_EQ(object_["missing"], nullptr);
+}
+
+TEST_F(KeyIndexTests, AddChildAfterLookup) {
+  ASSERT_NE(object_["key0"], nullptr);
+
+  auto added = object_.AddChild("value", "added");
+
+  EXPECT_EQ(object_["added"], added);
+  EXPECT_EQ(object_["key999"]->GetInt64(), 999);
+}
+
+TEST_F(KeyIndexTests, SetKeyRenamesAndRejectsDuplicates) {
+  auto member = object_["key10"];
+  ASSERT_NE(member, nullptr);
+
+  EXPECT_FALSE(member->SetKey("key20"));
+  EXPECT_EQ(object_["key20"]->GetInt64(), 20);
+
+  EXPECT_TRUE(member->SetKey("renamed"));
+  EXPECT_EQ(object_["renamed"], member);
+  EXPECT_EQ(object_["key10"], nullptr);
+}
+
+TEST_F(KeyIndexTests, DetachAndRemoveChildUpdateLookups) {
+  auto detached = object_["key5"]->Detach();
+  ASSERT_NE(detached, nullptr);
+  EXPECT_EQ(object_["key5"], nullptr);
+
+  ASSERT_TRUE(object_.RemoveChild(0));
+  EXPECT_EQ(object_["key0"], nullptr);
+  EXPECT_EQ(object_["key1"]->GetInt64(), 1);
+  EXPECT_EQ(std::get<ChildrenList>(object_.GetValue()).size(), kMembers - 2);
+}
+
+TEST_F(KeyIndexTests, FirstDuplicateKeyWins) {
+  auto duplicate = object_.AddChild(-1, "key3");
+  EXPECT_EQ(object_["key3"]->GetInt64(), 3);
+
+  object_["key3"]->Detach();
+  EXPECT_EQ(object_["key3"], duplicate);
+}
+
+TEST_F(KeyIndexTests, ParsedObjectKeepsMemberOrder) {
+  std::string data = "{";
+  for (int i = 0; i < 100; i++) data += "\"k" + std::to_string(99 - i) + "\":" + std::to_string(i) + ",";
+  data.back() = '}';
+
+  auto json = Json::Parse(data);
+  ASSERT_EQ(json->GetType(), Json::ValueType::Object);
+  EXPECT_EQ((*json)["k0"]->GetInt64(), 99);
+
+  auto& children = std::get<ChildrenList>(json->GetValue());
+  EXPECT_EQ(children.front()->ToString(), "\"k99\":0");
+  EXPECT_EQ(children.back()->ToString(), "\"k0\":99");
+}
+
+TEST_F(KeyIndexTests, ArenaObjectLookups) {
+  std::string data = "{";
+  for (int i = 0; i < 100; i++) data += "\"k" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+  data.back() = '}';
+
+  auto json = Json::Parse(data, ParseOptions{ .use_arena = true });
+  ASSERT_EQ(json->GetType(), Json::ValueType::Object);
+  EXPECT_EQ((*json)["k42"]->GetInt64(), 42);
+
+  EXPECT_TRUE((*json)["k42"]->SetKey("answer"));
+  EXPECT_EQ((*json)["answer"]->GetInt64(), 42);
+  EXPECT_EQ((*json)["k42"], nullptr);
+}
+
+TEST_F(KeyIndexTests, MoveAssignmentReindexesMembers) {
+  EXPECT_EQ(object_["key5"]->GetInt64(), 5);
+
+  Json other("renamed", nullptr);
+  other.SetValue(42);
+
+  *object_["key5"] = std::move(other);
+  EXPECT_EQ(object_["key5"], nullptr);
+  EXPECT_EQ(object_["renamed"]->GetInt64(), 42);
+  EXPECT_EQ(object_["key999"]->GetInt64(), 999);
+
+  *object_["key6"] = std::move(*object_["key7"]);
+  EXPECT_EQ(object_["key7"]->GetInt64(), 7);
+  EXPECT_EQ(object_["key998"]->GetInt64(), 998);
+}
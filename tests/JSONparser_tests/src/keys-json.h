@@ -0,0 +1,15 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "json.h"
+
+class KeyIndexTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    for (int i = 0; i < kMembers; i++) object_.AddChild(i, "key" + std::to_string(i));
+  }
+
+  static constexpr int kMembers = 1000;
+  Json object_;
+};
@@ -0,0 +1,173 @@
+#include "lazy-json.h"
+
+TEST_F(LazyTests, ReadsScalars) {
+  auto lazy = JsonLazy::Parse(document);
+  ASSERT_TRUE(lazy->IsValid());
+
+  auto root = lazy->GetRoot();
+  EXPECT_EQ(root.GetType(), Json::ValueType::Object);
+  EXPECT_EQ(root["id"].GetInt64(), 42);
+  EXPECT_TRUE(root["id"].IsInteger());
+  EXPECT_EQ(root["name"].GetString(), "lazy \"doc\"");
+  EXPECT_EQ(root["name"].GetKey(), "name");
+
+  auto items = root["items"];
+  EXPECT_EQ(items[1].GetNumber(), -2.5);
+  EXPECT_FALSE(items[1].IsInteger());
+  EXPECT_EQ(items[2].GetUInt64(), 18446744073709551615ull);
+  EXPECT_TRUE(items[3].GetBool());
+  EXPECT_FALSE(items[4].GetBool());
+  EXPECT_EQ(items[5].GetType(), Json::ValueType::Null);
+  EXPECT_TRUE(items[5].IsArrayElement());
+  EXPECT_EQ(items[6].Size(), 0);
+  EXPECT_FALSE(items[7].IsValid());
+  EXPECT_EQ(items.Size(), 7);
+
+  // Keys are compared decoded
+  EXPECT_EQ(root["abc"].GetString(), "escaped key");
+  EXPECT_EQ(root["abc"].GetKey(), "abc");
+}
+
+TEST_F(LazyTests, SkipsBracketsInStrings) {
+  auto lazy = JsonLazy::Parse(document);
+  auto root = lazy->GetRoot();
+
+  // The member after the skipped object is found, strings with brackets do not end it early
+  EXPECT_EQ(root["items"][0].GetInt64(), 1);
+  EXPECT_EQ(root["skip"]["deep"][0][1].GetString(), "}");
+  EXPECT_EQ(root["skip"]["deep"][1]["x"].GetString(), "\\");
+  EXPECT_EQ(root["skip"].GetRaw(), R"({ "deep" : [ [ "]", "}" ], { "x" : "\\" } ] })");
+}
+
+TEST_F(LazyTests, MissingMembers) {
+  auto lazy = JsonLazy::Parse(document);
+  auto root = lazy->GetRoot();
+
+  EXPECT_FALSE(root["missing"].IsValid());
+  EXPECT_EQ(root["missing"]["x"].GetType(), Json::ValueType::Undefined);
+  EXPECT_FALSE(root["id"]["x"].IsValid());
+  EXPECT_FALSE(root[-1].IsValid());
+  EXPECT_EQ(root[0].GetKey(), "id");
+  EXPECT_EQ(root.Size(), 5);
+}
+
+TEST_F(LazyTests, ScansOnlyWhatIsAccessed) {
+  auto lazy = JsonLazy::Parse(document);
+  auto root = lazy->GetRoot();
+
+  EXPECT_EQ(lazy->GetIndexedCount(), 0);
+
+  EXPECT_EQ(root["name"].GetString(), "lazy \"doc\"");
+  EXPECT_EQ(lazy->GetIndexedCount(), 1);
+
+  // The skipped object is never indexed itself
+  EXPECT_TRUE(root["items"][3].GetBool());
+  EXPECT_EQ(lazy->GetIndexedCount(), 2);
+  EXPECT_EQ(lazy->GetMaterializedCount(), 0);
+}
+
+TEST_F(LazyTests, MaterializesSubtrees) {
+  auto lazy = JsonLazy::Parse(document);
+  auto skip = lazy->GetRoot()["skip"];
+
+  auto json = skip.Materialize();
+  ASSERT_NE(json, nullptr);
+  EXPECT_EQ(json->ToString(), R"({"deep":[["]","}"],{"x":"\\"}]})");
+
+  // The subtree is built once
+  EXPECT_EQ(skip.Materialize(), json);
+  EXPECT_EQ(lazy->GetRoot()["skip"].Materialize(), json);
+  EXPECT_EQ(lazy->GetMaterializedCount(), 1);
+
+  EXPECT_EQ(JsonLazy::Element().Materialize(), nullptr);
+}
+
+TEST_F(LazyTests, ForEachChild) {
+  auto lazy = JsonLazy::Parse(document);
+
+  std::string keys;
+  lazy->GetRoot().ForEachChild([&keys](const JsonLazy::Element& child) {
+    keys += std::string(child.GetKey()) + ",";
+    });
+  EXPECT_EQ(keys, "id,name,skip,items,abc,");
+
+  std::string items;
+  lazy->GetRoot()["items"].ForEachChild([&items](const JsonLazy::Element& child) {
+    items += child.ToString();
+    });
+  EXPECT_EQ(items, "1-2.518446744073709551615truefalsenull{}");
+}
+
+TEST_F(LazyTests, ToString) {
+  auto lazy = JsonLazy::Parse(document);
+
+  EXPECT_EQ(lazy->ToString(), Json::Parse(document)->ToString());
+  EXPECT_EQ(lazy->GetRoot()["items"].ToString(), R"([1,-2.5,18446744073709551615,true,false,null,{}])");
+  EXPECT_EQ(lazy->GetMaterializedCount(), 0);
+}
+
+TEST_F(LazyTests, ScalarRoots) {
+  auto number = JsonLazy::Parse(" 12 ");
+  EXPECT_EQ(number->GetRoot().GetInt64(), 12);
+  EXPECT_FALSE(number->GetRoot().IsArrayElement());
+  ASSERT_NE(number->GetRoot().Materialize(), nullptr);
+  EXPECT_EQ(number->GetRoot().Materialize()->GetInt64(), 12);
+
+  auto text = JsonLazy::Parse(std::string("\"a\\nb\""));
+  EXPECT_EQ(text->GetRoot().GetString(), "a\nb");
+  EXPECT_EQ(text->GetRoot().GetRaw(), "\"a\\nb\"");
+}
+
+TEST_F(LazyTests, InvalidDocuments) {
+  for (auto data : { "", "  ", "{", R"({"a":1,})", "[1 2]", R"({"a":1} x)", R"(["]"])" "]" })
+  {
+    auto lazy = JsonLazy::Parse(data);
+    EXPECT_FALSE(lazy->IsValid()) << data;
+    EXPECT_FALSE(lazy->GetRoot().IsValid()) << data;
+    EXPECT_EQ(lazy->ToString(), "") << data;
+  }
+}
+
+TEST_F(LazyTests, ValidationDepthLimit) {
+  ParseOptions options;
+  options.max_depth = 4;
+
+  EXPECT_TRUE(JsonLazy::Parse(document, options)->IsValid());
+
+  options.max_depth = 3;
+  EXPECT_FALSE(JsonLazy::Parse(document, options)->IsValid());
+  EXPECT_FALSE(JsonLazy::Parse(std::string(100000, '[') + std::string(100000, ']'), options)->IsValid());
+}
+
+TEST_F(LazyTests, TrustedDocuments) {
+  auto lazy = JsonLazy::ParseTrusted(document);
+  EXPECT_EQ(lazy->GetRoot()["items"][2].GetUInt64(), 18446744073709551615ull);
+  EXPECT_EQ(lazy->GetRoot()["skip"]["deep"][1]["x"].GetString(), "\\");
+  EXPECT_FALSE(JsonLazy::ParseTrusted("  ")->IsValid());
+
+  // Invalid input gives whatever the scanner finds, within the bounds of the input
+  for (auto text : { "{", R"({"a)", R"({"a":)", R"({"a" 1)", R"({"a":[1,"x)", "[\"\\", "[,,1]", "[}", "tru" })
+  {
+    std::vector<char> buffer(text, text + std::strlen(text));
+    auto trusted = JsonLazy::ParseTrusted(std::string_view(buffer.data(), buffer.size()));
+    auto root = trusted->GetRoot();
+
+    root["a"][1].GetString();
+    root[2].GetInt64();
+    root.Size();
+    root.ForEachChild([](const JsonLazy::Element& child) { child.GetKey(); child.Materialize(); });
+    root.ToString();
+  }
+}
+
+TEST_F(LazyTests, FormFeedAndVerticalTabAreWhitespace) {
+  auto lazy = JsonLazy::Parse("\v{\"a\":\f1,\"b\":[\v2\f,\ftrue\v]\f}\f");
+  ASSERT_TRUE(lazy->IsValid());
+
+  auto root = lazy->GetRoot();
+  EXPECT_EQ(root["a"].GetRaw(), "1");
+  EXPECT_EQ(root["a"].GetInt64(), 1);
+  EXPECT_EQ(root["b"][0].GetInt64(), 2);
+  EXPECT_TRUE(root["b"][1].GetBool());
+  EXPECT_EQ(root.ToString(), R"({"a":1,"b":[2,true]})");
+}
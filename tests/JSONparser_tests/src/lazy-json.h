@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "json_lazy.h"
+
+class LazyTests : public testing::Test
+{
+protected:
+  static constexpr const char* document = R"( {
+    "id" : 42,
+    "name" : "lazy \"doc\"",
+    "skip" : { "deep" : [ [ "]", "}" ], { "x" : "\\" } ] },
+    "items" : [ 1, -2.5, 18446744073709551615, true, false, null, {} ],
+    "abc" : "escaped key"
+  } )";
+};
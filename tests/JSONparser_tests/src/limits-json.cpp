@@ -0,0 +1,125 @@
+#include "limits-json.h"
+
+TEST_F(LimitsTests, NoLimitsByDefault) {
+  EXPECT_EQ(ParseWith(MakeDocument(1000), ParseOptions()), ParseError::None);
+  EXPECT_EQ(ParseWith(MakeNested(100), ParseOptions()), ParseError::None);
+}
+
+TEST_F(LimitsTests, SyntaxErrorsAreReported) {
+  EXPECT_EQ(ParseWith("x", ParseOptions()), ParseError::Syntax);
+  EXPECT_EQ(ParseWith("", ParseOptions()), ParseError::Syntax);
+}
+
+TEST_F(LimitsTests, MaxDepth) {
+  ParseOptions options;
+  options.max_depth = 10;
+
+  EXPECT_EQ(ParseWith(MakeNested(10), options), ParseError::None);
+  EXPECT_EQ(ParseWith(MakeNested(11), options), ParseError::DepthLimit);
+  EXPECT_EQ(ParseWith(R"({"a":{"b":{"c":{"d":{"e":{"f":{"g":{"h":{"i":{"j":{"k":1}}}}}}}}}}})", options), ParseError::DepthLimit);
+
+  // The limit stops the descent long before the stack could run out
+  EXPECT_EQ(ParseWith(MakeNested(1000000), options), ParseError::DepthLimit);
+}
+
+TEST_F(LimitsTests, MaxInputSize) {
+  auto data = MakeDocument(100);
+
+  ParseOptions options;
+  options.max_input_size = data.size();
+  EXPECT_EQ(ParseWith(data, options), ParseError::None);
+
+  options.max_input_size = data.size() - 1;
+  EXPECT_EQ(ParseWith(data, options), ParseError::SizeLimit);
+}
+
+TEST_F(LimitsTests, MaxNodes) {
+  ParseOptions options;
+  options.max_nodes = 101;
+
+  EXPECT_EQ(ParseWith(MakeDocument(100), options), ParseError::None);
+  EXPECT_EQ(ParseWith(MakeDocument(101), options), ParseError::NodeLimit);
+}
+
+TEST_F(LimitsTests, MaxAllocatedBytes) {
+  auto data = MakeDocument(1000);
+
+  ParseOptions options;
+  options.max_allocated_bytes = 1024 * 1024;
+  EXPECT_EQ(ParseWith(data, options), ParseError::None);
+
+  options.max_allocated_bytes = 16 * 1024;
+  EXPECT_EQ(ParseWith(data, options), ParseError::MemoryLimit);
+
+  options.use_arena = true;
+  EXPECT_EQ(ParseWith(data, options), ParseError::MemoryLimit);
+}
+
+TEST_F(LimitsTests, Deadline) {
+  ParseOptions options;
+  options.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+  EXPECT_EQ(ParseWith(MakeDocument(10), options), ParseError::Deadline);
+
+  options.deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+  EXPECT_EQ(ParseWith(MakeDocument(10), options), ParseError::None);
+}
+
+TEST_F(LimitsTests, CancellationIsReported) {
+  JsonParser parser;
+  ParseOptions options;
+  options.progress_interval = 1024;
+
+  EXPECT_FALSE(parser.Parse(MakeDocument(1000), options, [](size_t) { return false; })->IsValid());
+  EXPECT_EQ(parser.GetError(), ParseError::Cancelled);
+
+  EXPECT_TRUE(parser.Parse(MakeDocument(10), options, ProgresCallback())->IsValid());
+  EXPECT_EQ(parser.GetError(), ParseError::None);
+}
+
+TEST_F(LimitsTests, PushParserLimits) {
+  JsonParser parser;
+  ParseOptions options;
+  options.max_depth = 10;
+
+  // An endless stream of brackets stops at the limit
+  parser.Start(options);
+  EXPECT_TRUE(parser.Feed(MakeNested(10)));
+  EXPECT_TRUE(parser.Finish()->IsValid());
+
+  parser.Start(options);
+  bool accepted = true;
+  for (int i = 0; i < 1000 && accepted; i++) accepted = parser.Feed("[");
+  EXPECT_FALSE(accepted);
+  EXPECT_FALSE(parser.Finish()->IsValid());
+  EXPECT_EQ(parser.GetError(), ParseError::DepthLimit);
+
+  options = ParseOptions();
+  options.max_nodes = 101;
+  parser.Start(options);
+  EXPECT_FALSE(parser.Feed(MakeDocument(101)));
+  EXPECT_EQ(parser.GetError(), ParseError::NodeLimit);
+
+  options = ParseOptions();
+  options.max_allocated_bytes = 16 * 1024;
+  parser.Start(options);
+  EXPECT_FALSE(parser.Feed(MakeDocument(1000)));
+  EXPECT_EQ(parser.GetError(), ParseError::MemoryLimit);
+
+  auto data = MakeDocument(100);
+  options = ParseOptions();
+  options.max_input_size = data.size() - 1;
+  parser.Start(options);
+  EXPECT_TRUE(parser.Feed(data.substr(0, 10)));
+  EXPECT_FALSE(parser.Feed(data.substr(10)));
+  EXPECT_EQ(parser.GetError(), ParseError::SizeLimit);
+
+  options = ParseOptions();
+  options.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+  parser.Start(options);
+  EXPECT_FALSE(parser.Feed(data));
+  EXPECT_EQ(parser.GetError(), ParseError::Deadline);
+
+  parser.Start();
+  EXPECT_FALSE(parser.Feed("[1,]"));
+  EXPECT_EQ(parser.GetError(), ParseError::Syntax);
+}
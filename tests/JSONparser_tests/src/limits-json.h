@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include "json.h"
+#include "json_parser.h"
+
+class LimitsTests : public testing::Test
+{
+protected:
+  static std::string MakeNested(size_t depth)
+  {
+    return std::string(depth, '[') + "1" + std::string(depth, ']');
+  }
+
+  static std::string MakeDocument(size_t members)
+  {
+    std::string data = "{";
+    for (size_t i = 0; i < members; i++)
+    {
+      if (i > 0) data += ",";
+      data += "\"key" + std::to_string(i) + "\":\"" + std::string(32, 'v') + "\"";
+    }
+    data += "}";
+
+    return data;
+  }
+
+  static ParseError ParseWith(const std::string& data, const ParseOptions& options)
+  {
+    ParseError error = ParseError::None;
+    auto json = Json::Parse(data, options, error);
+
+    EXPECT_EQ(json->IsValid(), error == ParseError::None);
+    return error;
+  }
+};
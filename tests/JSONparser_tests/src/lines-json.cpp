@@ -0,0 +1,68 @@
+#include "lines-json.h"
+
+TEST_F(LinesTests, DocumentsInInputOrder) {
+  auto documents = Json::ParseLines("{\"id\":1}\n[2]\r\n\n   \n{\"id\":3} \n{broken}\n\"text\"");
+
+  ASSERT_EQ(documents.size(), 5);
+  EXPECT_EQ((*documents[0])["id"]->GetInt64(), 1);
+  EXPECT_EQ(documents[1]->GetType(), Json::ValueType::Array);
+  EXPECT_EQ((*documents[2])["id"]->GetInt64(), 3);
+  EXPECT_EQ(documents[3]->GetType(), Json::ValueType::Undefined);
+  EXPECT_EQ(documents[4]->GetType(), Json::ValueType::String);
+}
+
+TEST_F(LinesTests, ManyChunksOnManyThreads) {
+  std::string data;
+  size_t count = 100000;
+  for (size_t i = 0; i < count; i++)
+  {
+    data += "{\"index\":" + std::to_string(i) + ",\"payload\":\"some text to fill the line\"}\n";
+  }
+  ASSERT_GT(data.size(), 4 * JSON_LINES_CHUNK_SIZE);
+
+  ThreadPool pool(4);
+  JsonLinesParser parser(pool, ParseOptions());
+  size_t expected = 0;
+  bool in_order = true;
+
+  parser.Parse(data, [&](size_t line, std::unique_ptr<Json> json) -> void {
+    in_order = in_order && line == expected && (*json)["index"]->GetUInt64() == expected;
+    expected++;
+    });
+
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(expected, count);
+}
+
+TEST_F(LinesTests, LineNumbersCountBlankLines) {
+  std::vector<size_t> lines;
+
+  Json::ParseLines("\n1\n\n2\n", [&lines](size_t line, std::unique_ptr<Json> /*json*/) -> void {
+    lines.push_back(line);
+    });
+
+  EXPECT_EQ(lines, std::vector<size_t>({ 1, 3 }));
+}
+
+TEST_F(LinesTests, LimitsApplyToEveryLine) {
+  ParseOptions options;
+  options.max_depth = 2;
+
+  auto documents = Json::ParseLines("[[1]]\n[[[1]]]\n\"text\"", options);
+
+  ASSERT_EQ(documents.size(), 3);
+  EXPECT_EQ(documents[0]->GetType(), Json::ValueType::Array);
+  EXPECT_EQ(documents[1]->GetType(), Json::ValueType::Undefined);
+  EXPECT_EQ(documents[2]->GetType(), Json::ValueType::String);
+}
+
+TEST_F(LinesTests, ParsedFromTaskOfSamePool) {
+  ThreadPool pool(1);
+  size_t count = 0;
+
+  // The only worker waits for the chunks of its own call and runs them itself
+  pool.Submit([&]() { count = Json::ParseLines(pool, "1\n2\n3\n").size(); });
+  pool.Wait();
+
+  EXPECT_EQ(count, 3);
+}
@@ -0,0 +1,8 @@
+#include <gtest/gtest.h>
+#include "json_lines.h"
+
+class LinesTests : public testing::Test
+{
+protected:
+
+};
@@ -0,0 +1,83 @@
+#include "parallel-json.h"
+
+TEST_F(ParallelTests, MatchesSequentialParse) {
+  std::string data = R"( {"name" : "root", "items": [ {"id": 1, "tags": ["a", "b\"c"]}, {"id": 2, "tags": []},
+    [1, 2, [3, 4, {"deep": null}]] ], "empty": {}, "esc\naped": true, "number": -1.5e3 } )";
+
+  auto json = ParseParallel(data);
+  ASSERT_EQ(json->GetType(), Json::ValueType::Object);
+  EXPECT_EQ(json->ToString(), JsonTape::Parse(data)->ToString());
+}
+
+TEST_F(ParallelTests, ParentLinks) {
+  auto json = ParseParallel(R"([{"list": [1, 2, 3], "other": "value with some length"}, [true, false], "text"])");
+  ASSERT_EQ(json->GetType(), Json::ValueType::Array);
+
+  auto first = (*json)[0];
+  auto list = (*first)["list"];
+  EXPECT_EQ(first->GetParent(), json.get());
+  EXPECT_EQ(list->GetParent(), first);
+  EXPECT_EQ((*list)[2]->GetParent(), list);
+  EXPECT_EQ((*list)[2]->GetInt64(), 3);
+  EXPECT_EQ((*(*json)[1])[1]->GetParent(), (*json)[1]);
+}
+
+TEST_F(ParallelTests, ArenaDocument) {
+  std::string data;
+  data += "[";
+  for (int i = 0; i < 1000; i++) data += (i ? "," : "") + std::string(R"({"index":)") + std::to_string(i) + "}";
+  data += "]";
+
+  auto json = ParseParallel(data, ParseOptions{ .use_arena = true });
+  ASSERT_EQ(json->GetType(), Json::ValueType::Array);
+  EXPECT_NE(json->GetArena(), nullptr);
+  EXPECT_EQ(std::get<ChildrenList>(json->GetValue()).size(), 1000);
+  EXPECT_EQ((*(*json)[999])["index"]->GetInt64(), 999);
+  EXPECT_EQ(json->ToString(), JsonTape::Parse(data)->ToString());
+}
+
+TEST_F(ParallelTests, InvalidDocuments) {
+  for (auto data : { R"([1, 2,])", R"([, 1])", R"({"a": 1,})", R"({"a" 1})", R"({"a": })", R"([1 2])",
+    R"([{"a": [1}], 2])", R"([[1, 2], [3, 4})", R"({"a": 1} [])", R"([1, 2)", R"([ "unterminated ])", R"({1: 2})" })
+  {
+    EXPECT_EQ(ParseParallel(data)->GetType(), Json::ValueType::Undefined) << data;
+    EXPECT_EQ(ParseParallel(data, ParseOptions{ .use_arena = true })->GetType(), Json::ValueType::Undefined) << data;
+  }
+
+  auto empty = ParseParallel("[]");
+  EXPECT_EQ(empty->GetType(), Json::ValueType::Array);
+  EXPECT_TRUE(std::get<ChildrenList>(empty->GetValue()).empty());
+
+  // Scalar roots are rejected like by Json::Parse
+  EXPECT_EQ(ParseParallel(" 42 ")->GetType(), Json::Parse(" 42 ")->GetType());
+  EXPECT_EQ(Json::ParseParallel("\"text\"")->GetType(), Json::ValueType::Undefined);
+}
+
+TEST_F(ParallelTests, LimitsApplyToWholeDocument) {
+  std::string data = "[";
+  for (int i = 0; i < 1000; i++) data += R"({"index":[[)" + std::to_string(i) + "]]},";
+  data.back() = ']';
+
+  ParseOptions options;
+  options.max_depth = 4;
+  EXPECT_EQ(ParseParallel(data, options)->GetType(), Json::ValueType::Array);
+
+  options.max_depth = 3;
+  EXPECT_EQ(ParseParallel(data, options)->GetType(), Json::ValueType::Undefined);
+
+  // Every element holds four nodes, no task reaches the limit alone
+  options = ParseOptions();
+  options.max_nodes = 4001;
+  EXPECT_EQ(ParseParallel(data, options)->GetType(), Json::ValueType::Array);
+
+  options.max_nodes = 4000;
+  EXPECT_EQ(ParseParallel(data, options)->GetType(), Json::ValueType::Undefined);
+
+  options = ParseOptions();
+  options.max_input_size = data.size() - 1;
+  EXPECT_EQ(ParseParallel(data, options)->GetType(), Json::ValueType::Undefined);
+
+  options = ParseOptions();
+  options.max_allocated_bytes = 1000 * sizeof(Json);
+  EXPECT_EQ(ParseParallel(data, options)->GetType(), Json::ValueType::Undefined);
+}
@@ -0,0 +1,16 @@
+#include <gtest/gtest.h>
+#include "json_parallel.h"
+#include "json_tape.h"
+
+class ParallelTests : public testing::Test
+{
+protected:
+  std::unique_ptr<Json> ParseParallel(const std::string& data, const ParseOptions& options = ParseOptions())
+  {
+    // Small documents with many threads are split down to single elements
+    JsonParallelParser parser(pool_, options);
+    return parser.Parse(data);
+  }
+
+  ThreadPool pool_{ 8 };
+};
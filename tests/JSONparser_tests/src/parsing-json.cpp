@@ -87,7 +87,7 @@ TEST_F(ParsingTests, ObjectWithValidNumberElement) {
   EXPECT_STREQ(child_element->GetKey().c_str(), "key");
   EXPECT_EQ(child_element->GetParent(), json.get());
   EXPECT_EQ(child_element->GetType(), Json::ValueType::Number);
-  EXPECT_EQ(std::get<Number>(child_element->GetValue()), 14);
+  EXPECT_EQ(std::get<Integer>(child_element->GetValue()), 14);
 }
 
 TEST_F(ParsingTests, ObjectWithValidStringElement) {
@@ -319,4 +319,94 @@ TEST_F(ParsingTests, ObjectWithNestedArrays) {
   EXPECT_EQ(nested2->GetParent(), element3.get());
   EXPECT_EQ(nested2->GetType(), Json::ValueType::Bool);
   EXPECT_EQ(std::get<Bool>(nested2->GetValue()), true);
-}
\ No newline at end of file
+}
+
+TEST_F(ParsingTests, ObjectWithLongAndEscapedStrings) {
+  std::string long_value(1000, 'x');
+  auto json = Json::Parse(R"({ "long" : ")" + long_value + R"(", "escaped\tkey" : "a\"b\\c\nd", "tail" : "x" })");
+
+  EXPECT_EQ(json->GetType(), Json::ValueType::Object);
+
+  auto& json_children = std::get<ChildrenList>(json->GetValue());
+  ASSERT_EQ(json_children.size(), 3);
+
+  EXPECT_EQ(json_children.at(0)->GetKey(), "long");
+  EXPECT_EQ(std::get<String>(json_children.at(0)->GetValue()), std::string_view(long_value));
+
+  EXPECT_EQ(json_children.at(1)->GetKey(), "escaped\tkey");
+  EXPECT_EQ(std::get<String>(json_children.at(1)->GetValue()), "a\"b\\c\nd");
+
+  EXPECT_EQ(json_children.at(2)->GetKey(), "tail");
+  EXPECT_EQ(std::get<String>(json_children.at(2)->GetValue()), "x");
+}
+
+TEST_F(ParsingTests, ArrayWithValidNumbers) {
+  auto json = Json::Parse(R"([0, -0.5, 12.25e+2, 1E-2, -123456789012345678, 0.1, 1.7976931348623157e308])");
+
+  EXPECT_EQ(json->GetType(), Json::ValueType::Array);
+
+  auto& values = std::get<ChildrenList>(json->GetValue());
+  ASSERT_EQ(values.size(), 7);
+
+  for (auto& value : values) EXPECT_EQ(value->GetType(), Json::ValueType::Number);
+
+  EXPECT_EQ(std::get<Integer>(values.at(0)->GetValue()), 0);
+  EXPECT_EQ(std::get<Number>(values.at(1)->GetValue()), -0.5);
+  EXPECT_EQ(std::get<Number>(values.at(2)->GetValue()), 1225);
+  EXPECT_EQ(std::get<Number>(values.at(3)->GetValue()), 0.01);
+  EXPECT_EQ(std::get<Integer>(values.at(4)->GetValue()), -123456789012345678);
+  EXPECT_EQ(std::get<Number>(values.at(5)->GetValue()), 0.1);
+  EXPECT_EQ(std::get<Number>(values.at(6)->GetValue()), 1.7976931348623157e308);
+}
+
+TEST_F(ParsingTests, ArrayWithLargeIntegers) {
+  auto json = Json::Parse(R"([9007199254740993, 18446744073709551615, -9223372036854775808, 18446744073709551616])");
+
+  EXPECT_EQ(json->GetType(), Json::ValueType::Array);
+
+  auto& values = std::get<ChildrenList>(json->GetValue());
+  ASSERT_EQ(values.size(), 4);
+
+  EXPECT_TRUE(values.at(0)->IsInteger());
+  EXPECT_EQ(values.at(0)->GetInt64(), 9007199254740993);
+  EXPECT_EQ(std::get<Unsigned>(values.at(1)->GetValue()), 18446744073709551615ull);
+  EXPECT_EQ(values.at(2)->GetInt64(), INT64_MIN);
+  EXPECT_FALSE(values.at(3)->IsInteger());
+  EXPECT_EQ(values.at(3)->GetNumber(), 18446744073709551616.0);
+
+  EXPECT_EQ(values.at(1)->ToString(), "18446744073709551615");
+  EXPECT_EQ(values.at(2)->ToString(), "-9223372036854775808");
+}
+
+TEST_F(ParsingTests, SetIntegerValues) {
+  Json json("", nullptr);
+
+  json.SetValue(42);
+  EXPECT_EQ(json.GetType(), Json::ValueType::Number);
+  EXPECT_EQ(std::get<Integer>(json.GetValue()), 42);
+
+  json.SetValue(uint64_t(1) << 63);
+  EXPECT_EQ(json.GetUInt64(), uint64_t(1) << 63);
+
+  json.SetValue(2.5);
+  EXPECT_FALSE(json.IsInteger());
+  EXPECT_EQ(json.GetInt64(), 2);
+}
+
+TEST_F(ParsingTests, KeyAndStringAccessors) {
+  std::string data = R"({ "a key longer than the small buffer" : "a value longer than the small buffer", "n" : 1 })";
+
+  // Keys and strings are std::string whether the document uses an arena or not
+  for (bool use_arena : { false, true })
+  {
+    auto json = Json::Parse(data, ParseOptions{ .use_arena = use_arena });
+    auto member = (*json)["a key longer than the small buffer"];
+    ASSERT_NE(member, nullptr);
+
+    const std::string& key = member->GetKey();
+    EXPECT_EQ(key, "a key longer than the small buffer");
+    EXPECT_EQ(std::get<std::string>(member->GetValue()), "a value longer than the small buffer");
+    EXPECT_EQ(member->GetString(), "a value longer than the small buffer");
+    EXPECT_EQ((*json)["n"]->GetString(), "");
+  }
+}
@@ -0,0 +1,108 @@
+#include "pointer-json.h"
+
+TEST_F(PointerTests, RfcExamples) {
+  auto json = Json::Parse(rfc_document);
+  auto compact = JsonCompact::Parse(rfc_document);
+  ASSERT_TRUE(json->IsValid());
+
+  EXPECT_EQ(JsonPointer("").Resolve(*json), json.get());
+  EXPECT_EQ(JsonPointer("/foo").Resolve(*json)->GetType(), Json::ValueType::Array);
+  EXPECT_EQ(std::get<String>(JsonPointer("/foo/1").Resolve(*json)->GetValue()), "baz");
+  EXPECT_EQ(JsonPointer("/foo/1").Resolve(*compact).GetString(), "baz");
+
+  std::vector<std::pair<std::string, Integer>> members = {
+    { "/", 0 }, { "/a~1b", 1 }, { "/c%d", 2 }, { "/e^f", 3 }, { "/g|h", 4 },
+    { "/i\\j", 5 }, { "/k\"l", 6 }, { "/ ", 7 }, { "/m~0n", 8 },
+  };
+
+  for (auto& [pointer, value] : members)
+  {
+    JsonPointer compiled(pointer);
+    ASSERT_TRUE(compiled.IsValid()) << pointer;
+    EXPECT_EQ(compiled.ToString(), pointer);
+
+    auto node = compiled.Resolve(*json);
+    ASSERT_NE(node, nullptr) << pointer;
+    EXPECT_EQ(node->GetInt64(), value) << pointer;
+    EXPECT_EQ(compiled.Resolve(*compact).GetInt64(), value) << pointer;
+  }
+}
+
+TEST_F(PointerTests, InvalidSyntax) {
+  EXPECT_FALSE(JsonPointer("foo").IsValid());
+  EXPECT_FALSE(JsonPointer("/a~2b").IsValid());
+  EXPECT_FALSE(JsonPointer("/a~").IsValid());
+  EXPECT_TRUE(JsonPointer("/a~01").IsValid());
+  EXPECT_EQ(JsonPointer("/a~01").ToString(), "/a~01");
+
+  auto json = Json::Parse(rfc_document);
+  EXPECT_EQ(JsonPointer("foo").Resolve(*json), nullptr);
+}
+
+TEST_F(PointerTests, MissingValues) {
+  auto json = Json::Parse(R"({"list":[1,2,3],"object":{"a":1}})");
+  auto compact = JsonCompact::Parse(R"({"list":[1,2,3],"object":{"a":1}})");
+
+  for (auto pointer : { "/missing", "/list/3", "/list/-", "/list/01", "/list/a", "/object/b", "/object/a/b", "/list/0/x" })
+  {
+    EXPECT_EQ(JsonPointer(pointer).Resolve(*json), nullptr) << pointer;
+    EXPECT_FALSE(JsonPointer(pointer).Resolve(*compact).IsValid()) << pointer;
+  }
+
+  // Numeric tokens are keys in objects
+  auto numbers = Json::Parse(R"({"0":"zero","items":[{"1":"one"}]})");
+  EXPECT_EQ(std::get<String>(JsonPointer("/0").Resolve(*numbers)->GetValue()), "zero");
+  EXPECT_EQ(std::get<String>(JsonPointer("/items/0/1").Resolve(*numbers)->GetValue()), "one");
+}
+
+TEST_F(PointerTests, HintsFollowTheLayout) {
+  JsonPointer price("/payload/items/1/price");
+
+  // Same layout, then members in a different order, then the first layout again
+  std::vector<std::string> documents = {
+    R"({"id":1,"payload":{"name":"a","items":[{"price":1},{"price":2}]}})",
+    R"({"id":2,"payload":{"name":"b","items":[{"price":3},{"price":4}]}})",
+    R"({"payload":{"items":[{"price":5},{"tax":0,"price":6}],"name":"c"},"id":3})",
+    R"({"id":4,"payload":{"name":"d","items":[{"price":7},{"price":8}]}})",
+  };
+
+  std::vector<Integer> expected = { 2, 4, 6, 8 };
+
+  for (size_t i = 0; i < documents.size(); i++)
+  {
+    auto json = Json::Parse(documents[i]);
+    auto compact = JsonCompact::Parse(documents[i]);
+
+    ASSERT_NE(price.Resolve(*json), nullptr);
+    EXPECT_EQ(price.Resolve(*json)->GetInt64(), expected[i]);
+    EXPECT_EQ(price.Resolve(*compact).GetInt64(), expected[i]);
+  }
+}
+
+TEST_F(PointerTests, SharedBetweenThreads) {
+  JsonPointer pointer("/a/b");
+  auto first = Json::Parse(R"({"a":{"b":1,"c":2}})");
+  auto second = Json::Parse(R"({"a":{"c":2,"b":1}})");
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 1000; i++)
+      {
+        auto& json = (i + t) % 2 == 0 ? *first : *second;
+        auto node = pointer.Resolve(json);
+        EXPECT_TRUE(node != nullptr && node->GetInt64() == 1);
+      }
+      });
+  }
+
+  for (auto& thread : threads) thread.join();
+}
+
+TEST_F(PointerTests, MutableResolve) {
+  auto json = Json::Parse(R"({"a":{"b":"old"}})");
+  JsonPointer("/a/b").Resolve(*json)->SetValue("new");
+
+  EXPECT_EQ(json->ToString(), R"({"a":{"b":"new"}})");
+}
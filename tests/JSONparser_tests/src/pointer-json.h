@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "json.h"
+#include "json_compact.h"
+#include "json_pointer.h"
+
+class PointerTests : public testing::Test
+{
+protected:
+  /* Example document of RFC 6901 section 5 */
+  static constexpr const char* rfc_document = R"({
+    "foo": ["bar", "baz"],
+    "": 0,
+    "a/b": 1,
+    "c%d": 2,
+    "e^f": 3,
+    "g|h": 4,
+    "i\\j": 5,
+    "k\"l": 6,
+    " ": 7,
+    "m~n": 8
+  })";
+};
@@ -0,0 +1,87 @@
+#include "progress-json.h"
+
+TEST_F(ProgressTests, InlineReportsIncreaseToCompletion) {
+  auto data = MakeDocument(20000);
+
+  ParseOptions options;
+  options.progress_interval = 16 * 1024;
+
+  std::vector<size_t> reports;
+  auto thread_id = std::this_thread::get_id();
+  bool same_thread = true;
+
+  auto json = Json::Parse(data, options, [&](size_t progress) {
+    reports.push_back(progress);
+    same_thread = same_thread && std::this_thread::get_id() == thread_id;
+    return true;
+    });
+
+  ASSERT_TRUE(json->IsValid());
+  EXPECT_TRUE(same_thread);
+  EXPECT_GE(reports.size(), data.size() / options.progress_interval);
+  EXPECT_TRUE(std::is_sorted(reports.begin(), reports.end()));
+  EXPECT_EQ(reports.back(), 100);
+  EXPECT_EQ(json->ToString(), Json::Parse(data)->ToString());
+}
+
+TEST_F(ProgressTests, SmallDocumentsOnlyReportCompletion) {
+  std::vector<size_t> reports;
+  auto json = Json::Parse(R"({"a":1})", [&](size_t progress) { reports.push_back(progress); return true; });
+
+  ASSERT_TRUE(json->IsValid());
+  EXPECT_EQ(reports, std::vector<size_t>{ 100 });
+}
+
+TEST_F(ProgressTests, CancellationStopsAtCheckpoint) {
+  auto data = MakeDocument(20000);
+
+  ParseOptions options;
+  options.progress_interval = 4 * 1024;
+
+  size_t calls = 0;
+  auto json = Json::Parse(data, options, [&](size_t /*progress*/) {
+    calls++;
+    return calls < 3;
+    });
+
+  EXPECT_FALSE(json->IsValid());
+  EXPECT_EQ(calls, 3);
+}
+
+TEST_F(ProgressTests, ParserIsReusableAfterCancellation) {
+  auto data = MakeDocument(5000);
+  JsonParser parser;
+
+  ParseOptions options;
+  options.progress_interval = 1024;
+
+  EXPECT_FALSE(parser.Parse(data, options, [](size_t) { return false; })->IsValid());
+  EXPECT_TRUE(parser.Parse(data, options, ProgresCallback())->IsValid());
+}
+
+TEST_F(ProgressTests, SharedReporterServesConcurrentParses) {
+  auto data = MakeDocument(20000);
+
+  ParseOptions options;
+  options.progress_reporter = true;
+
+  std::atomic<size_t> completed{ 0 };
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 4; i++)
+  {
+    threads.emplace_back([&]() {
+      size_t last = 0;
+      auto json = Json::Parse(data, options, [&](size_t progress) {
+        EXPECT_GE(progress, last);
+        last = progress;
+        return true;
+        });
+
+      if (json->IsValid() && last == 100) completed++;
+      });
+  }
+
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(completed, 4);
+}
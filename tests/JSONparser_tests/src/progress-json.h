@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "json.h"
+#include "json_parser.h"
+#include "json_progress.h"
+
+class ProgressTests : public testing::Test
+{
+protected:
+  static std::string MakeDocument(size_t members)
+  {
+    std::string data = "{";
+    for (size_t i = 0; i < members; i++)
+    {
+      if (i > 0) data += ",";
+      data += "\"key" + std::to_string(i) + "\":[" + std::to_string(i) + ",\"value\",true]";
+    }
+    data += "}";
+
+    return data;
+  }
+};
@@ -0,0 +1,51 @@
+#include "push-json.h"
+
+TEST_F(PushParserTests, ChunkBoundariesEverywhere) {
+  std::string data = R"( {"name" : "esc\"aped\\ value", "numbers": [0, -12.5e-3, 18446744073709551615, 42],
+    "flags": [true, false, null], "nested": {"empty": {}, "list": []}} )";
+  auto expected = Json::Parse(data)->ToString();
+
+  for (size_t chunk_size = 1; chunk_size <= data.size(); chunk_size++)
+  {
+    auto json = ParseInChunks(data, chunk_size);
+    ASSERT_EQ(json->GetType(), Json::ValueType::Object) << "chunk size " << chunk_size;
+    EXPECT_EQ(json->ToString(), expected) << "chunk size " << chunk_size;
+  }
+}
+
+TEST_F(PushParserTests, Values) {
+  auto json = ParseInChunks(R"({"text":"a\nb","number":12,"list":[1.5,"x",true]})", 3);
+
+  ASSERT_EQ(json->GetType(), Json::ValueType::Object);
+  EXPECT_EQ(std::get<String>((*json)["text"]->GetValue()), std::string_view("a\nb"));
+  EXPECT_EQ((*json)["number"]->GetInt64(), 12);
+  EXPECT_EQ((*(*json)["list"])[0]->GetNumber(), 1.5);
+  EXPECT_EQ((*(*json)["list"])[2]->GetType(), Json::ValueType::Bool);
+}
+
+TEST_F(PushParserTests, InvalidDocuments) {
+  for (auto data : { R"({"key": })", R"({"key" 1})", R"([1,])", R"([1 2])", R"({"a":tru})",
+    R"(["bad \x"])", R"([01])", R"([1] [])", R"("string")", R"({"open": [1, 2)" })
+  {
+    for (size_t chunk_size : { 1, 2, 64 })
+    {
+      EXPECT_EQ(ParseInChunks(data, chunk_size)->GetType(), Json::ValueType::Undefined) << data;
+    }
+  }
+}
+
+TEST_F(PushParserTests, ParserIsReusable) {
+  JsonParser parser;
+
+  parser.Feed(R"({"first":)");
+  EXPECT_EQ(parser.Finish()->GetType(), Json::ValueType::Undefined);
+
+  parser.Start(ParseOptions{ .use_arena = true });
+  EXPECT_TRUE(parser.Feed(R"([1, 2)"));
+  EXPECT_TRUE(parser.Feed(R"(, 3])"));
+
+  auto json = parser.Finish();
+  ASSERT_EQ(json->GetType(), Json::ValueType::Array);
+  EXPECT_NE(json->GetArena(), nullptr);
+  EXPECT_EQ(std::get<ChildrenList>(json->GetValue()).size(), 3);
+}
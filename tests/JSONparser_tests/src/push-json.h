@@ -0,0 +1,19 @@
+#include <gtest/gtest.h>
+#include "json_parser.h"
+
+class PushParserTests : public testing::Test
+{
+protected:
+  std::unique_ptr<Json> ParseInChunks(const std::string& data, size_t chunk_size)
+  {
+    JsonParser parser;
+    parser.Start();
+
+    for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+    {
+      if (!parser.Feed(std::string_view(data).substr(offset, chunk_size))) break;
+    }
+
+    return parser.Finish();
+  }
+};
@@ -0,0 +1,104 @@
+#include "ranges-json.h"
+
+static_assert(std::ranges::view<JsonDescendants<true>>);
+static_assert(std::ranges::forward_range<JsonDescendants<false>>);
+static_assert(std::ranges::random_access_range<decltype(std::declval<Json&>().Children())>);
+
+TEST_F(RangesTests, ForEachChildVisitsChildrenInOrder) {
+  auto json = Json::Parse(document);
+
+  std::string keys;
+  const Json& root = *json;
+  root.ForEachChild([&keys](const Json& child) { keys += child.GetKey(); });
+  EXPECT_EQ(keys, "abde");
+
+  // The mutable overload hands out the children for changes
+  (*json)["b"]->ForEachChild([](Json& child) { child.SetValue(1); });
+  EXPECT_EQ(json->ToString(), R"({"a":1,"b":[1,1,1],"d":{},"e":null})");
+
+  Json scalar;
+  scalar.ForEachChild([&keys](const Json&) { keys += "!"; });
+  EXPECT_EQ(keys, "abde");
+}
+
+TEST_F(RangesTests, ForEachChildOfOtherDocuments) {
+  auto compact = JsonCompact::Parse(document);
+  auto tape = JsonTape::Parse(document);
+
+  std::string compact_keys;
+  compact->GetRoot().ForEachChild([&compact_keys](const JsonCompact::Element& child) { compact_keys += child.GetKey(); });
+  EXPECT_EQ(compact_keys, "abde");
+
+  std::string tape_keys;
+  tape->GetRoot()["b"].ForEachChild([&tape_keys](const JsonTape::Element& child) { tape_keys += child.ToString(); });
+  EXPECT_EQ(tape_keys, R"(true{"c":"x"}[])");
+}
+
+TEST_F(RangesTests, Children) {
+  auto json = Json::Parse(document);
+
+  EXPECT_EQ(Keys(json->Children()), "abde");
+  EXPECT_EQ(Keys((*json)["b"]->Children()), "###");
+  EXPECT_TRUE((*json)["d"]->Children().empty());
+  EXPECT_TRUE((*json)["a"]->Children().empty());
+
+  auto children = json->Children();
+  EXPECT_EQ(children.size(), 4);
+  EXPECT_EQ(children[1].GetType(), Json::ValueType::Array);
+}
+
+TEST_F(RangesTests, DescendantsInPreOrder) {
+  auto json = Json::Parse(document);
+
+  EXPECT_EQ(Keys(json->Descendants()), "ab##c#de");
+  EXPECT_EQ(Keys((*json)["b"]->Descendants()), "##c#");
+  EXPECT_TRUE((*json)["d"]->Descendants().empty());
+  EXPECT_TRUE((*json)["e"]->Descendants().empty());
+  EXPECT_EQ(std::ranges::distance(json->Descendants()), 8);
+
+  // Iterators are forward iterators, a copy walks on its own
+  auto it = json->Descendants().begin();
+  auto copy = it++;
+  EXPECT_EQ(copy->GetKey(), "a");
+  EXPECT_EQ(it->GetKey(), "b");
+  EXPECT_NE(copy, it);
+  EXPECT_EQ(++copy, it);
+}
+
+TEST_F(RangesTests, DescendantsOfDeepDocument) {
+  std::string data(100000, '[');
+  data += std::string(100000, ']');
+  auto json = Json::Parse(data, ParseOptions{ .max_depth = 0 });
+  ASSERT_TRUE(json->IsValid());
+
+  EXPECT_EQ(std::ranges::distance(json->Descendants()), 99999);
+  EXPECT_EQ(std::ranges::distance(json->Leaves()), 1);
+}
+
+TEST_F(RangesTests, Leaves) {
+  auto json = Json::Parse(document);
+  const Json& root = *json;
+
+  EXPECT_EQ(Keys(root.Leaves()), "a#c#de");
+  EXPECT_TRUE((*json)["a"]->Leaves().empty());
+}
+
+TEST_F(RangesTests, ComposesWithRangeAdaptors) {
+  auto json = Json::Parse(R"({"a":1,"b":{"c":2,"d":"x","e":[3,4.5]}})");
+
+  auto numbers = json->Descendants()
+    | std::views::filter([](const Json& node) { return node.GetType() == Json::ValueType::Number; })
+    | std::views::transform([](const Json& node) { return node.GetNumber(); });
+
+  std::vector<Number> values;
+  std::ranges::copy(numbers, std::back_inserter(values));
+  EXPECT_EQ(values, (std::vector<Number>{ 1, 2, 3, 4.5 }));
+
+  // Elements can be changed through the mutable views
+  for (Json& leaf : json->Leaves() | std::views::filter([](const Json& node) { return node.IsInteger(); }))
+  {
+    leaf.SetValue(leaf.GetInt64() * 10);
+  }
+
+  EXPECT_EQ(json->ToString(), R"({"a":10,"b":{"c":20,"d":"x","e":[30,4.5]}})");
+}
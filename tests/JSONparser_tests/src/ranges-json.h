@@ -0,0 +1,24 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "json_compact.h"
+#include "json_tape.h"
+
+class RangesTests : public testing::Test
+{
+protected:
+  static constexpr const char* document = R"({"a":1,"b":[true,{"c":"x"},[]],"d":{},"e":null})";
+
+  /* Keys of a range, array elements are written as # */
+  template<class R>
+  static std::string Keys(R&& range)
+  {
+    std::string keys;
+    for (const Json& node : range) keys += node.IsArrayElement() ? std::string("#") : std::string(node.GetKey());
+    return keys;
+  }
+};
@@ -0,0 +1,67 @@
+#include "sax-json.h"
+
+TEST_F(SaxTests, EventsReachHandler) {
+  CountingHandler handler;
+  JsonSaxParser<CountingHandler> parser(handler);
+
+  EXPECT_TRUE(parser.Parse(R"({"a":1,"b\n":[2,3,{"c":4}],"d":"text","e":null,"f":1.5})"));
+  EXPECT_EQ(handler.objects, 2);
+  EXPECT_EQ(handler.arrays, 1);
+  EXPECT_EQ(handler.sum, 10);
+  EXPECT_EQ(handler.keys, "a;b\n;c;d;e;f;");
+}
+
+TEST_F(SaxTests, HandlerStopsParsing) {
+  CountingHandler handler;
+  handler.stop_on_null = true;
+  JsonSaxParser<CountingHandler> parser(handler);
+
+  EXPECT_FALSE(parser.Parse(R"([1, null, 2])"));
+  EXPECT_EQ(handler.sum, 1);
+}
+
+TEST_F(SaxTests, InvalidDocuments) {
+  JsonSaxHandler handler;
+  JsonSaxParser<JsonSaxHandler> parser(handler);
+
+  EXPECT_TRUE(parser.Parse(R"( [1, "two", {"three": true}] )"));
+  EXPECT_FALSE(parser.Parse(R"([1, 2)"));
+  EXPECT_FALSE(parser.Parse(R"({"a" 1})"));
+  EXPECT_FALSE(parser.Parse(R"([nul])"));
+  EXPECT_FALSE(parser.Parse(R"([1] 2)"));
+  EXPECT_FALSE(parser.Parse(""));
+}
+
+TEST_F(SaxTests, DeepNesting) {
+  std::string data = std::string(300000, '[') + std::string(300000, ']');
+
+  // Containers are tracked on the heap, depth does not reach the call stack
+  CountingHandler handler;
+  JsonSaxParser<CountingHandler> parser(handler);
+  EXPECT_TRUE(parser.Parse(data));
+  EXPECT_EQ(handler.arrays, 300000);
+
+  JsonSaxParser<CountingHandler> limited(handler, 100);
+  EXPECT_FALSE(limited.Parse(data));
+  EXPECT_TRUE(limited.Parse(std::string(100, '[') + std::string(100, ']')));
+  EXPECT_FALSE(limited.Parse(std::string(101, '{') + std::string(101, '}')));
+
+  EXPECT_TRUE(JsonTape::Parse(data)->IsValid());
+  EXPECT_TRUE(JsonCompact::Parse(data)->IsValid());
+}
+
+TEST_F(SaxTests, ContainerCounts) {
+  class CountsHandler : public JsonSaxHandler {
+  public:
+    bool OnEndObject(size_t count) { counts += "o" + std::to_string(count); return true; }
+    bool OnEndArray(size_t count) { counts += "a" + std::to_string(count); return true; }
+
+    std::string counts;
+  };
+
+  CountsHandler handler;
+  JsonSaxParser<CountsHandler> parser(handler);
+
+  EXPECT_TRUE(parser.Parse(R"({"a":[],"b":[1,{"c":{}},[2,3]],"d":{"e":1,"f":2}})"));
+  EXPECT_EQ(handler.counts, "a0o0o1a2a3o2o3");
+}
@@ -0,0 +1,24 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "json_sax.h"
+#include "json_tape.h"
+#include "json_compact.h"
+
+class SaxTests : public testing::Test
+{
+protected:
+  class CountingHandler : public JsonSaxHandler {
+  public:
+    bool OnStartObject() { objects++; return true; }
+    bool OnStartArray() { arrays++; return true; }
+    bool OnKey(std::string_view key) { keys += std::string(key) + ";"; return true; }
+    bool OnInt64(Integer value) { sum += value; return true; }
+    bool OnNull() { return !stop_on_null; }
+
+    int objects = 0;
+    int arrays = 0;
+    Integer sum = 0;
+    std::string keys;
+    bool stop_on_null = false;
+  };
+};
@@ -0,0 +1,123 @@
+#include "search-json.h"
+
+TEST_F(SearchTests, FindIfReturnsFirstMatchInDocumentOrder) {
+  auto json = Json::Parse(R"({"a":{"x":1},"b":[{"x":2}],"c":3})");
+
+  auto found = json->FindIf([](const Json& node) { return node.GetKey() == "x"; });
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->GetInt64(), 1);
+
+  // The match is not lost when later siblings have none
+  auto first = json->FindIf([](const Json& node) { return node.GetKey() == "a"; });
+  EXPECT_EQ(first, (*json)["a"]);
+
+  EXPECT_EQ(json->FindIf([](const Json& node) { return node.GetKey() == "missing"; }), nullptr);
+}
+
+TEST_F(SearchTests, FindIfStopsAtFirstMatch) {
+  auto json = MakeLarge(1000);
+
+  size_t visited = 0;
+  auto found = json->FindIf([&visited](const Json& node) {
+    visited++;
+    return node.GetType() == Json::ValueType::Number;
+    });
+
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->GetInt64(), 0);
+  EXPECT_EQ(visited, 3);
+}
+
+TEST_F(SearchTests, FindAllIfIntoReusedVector) {
+  auto json = MakeLarge(100);
+  std::vector<Json*> found;
+
+  json->FindAllIf([](const Json& node) { return node.GetType() == Json::ValueType::String && std::get<String>(node.GetValue()) == "t3"; }, found);
+  ASSERT_EQ(found.size(), 14);
+  EXPECT_EQ(found.front()->GetParent()->GetParent(), (*json)[3]);
+
+  json->FindAllIf([](const Json& node) { return node.GetKey() == "id"; }, found);
+  ASSERT_EQ(found.size(), 100);
+  for (size_t i = 0; i < found.size(); i++) EXPECT_EQ(found[i]->GetInt64(), static_cast<Integer>(i));
+
+  auto list = json->FindAllIf([](const Json& node) { return node.GetKey() == "id"; });
+  EXPECT_EQ(std::vector<Json*>(list.begin(), list.end()), found);
+}
+
+TEST_F(SearchTests, DeepDocumentsDoNotUseTheStack) {
+  auto json = Json::Parse(std::string(200000, '[') + "1" + std::string(200000, ']'));
+  ASSERT_TRUE(json->IsValid());
+
+  auto found = json->FindIf([](const Json& node) { return node.GetType() == Json::ValueType::Number; });
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->GetInt64(), 1);
+}
+
+TEST_F(SearchTests, ParallelMatchesSequential) {
+  ThreadPool pool(4);
+  auto json = MakeLarge(20000);
+
+  auto predicate = [](const Json& node) { return node.GetType() == Json::ValueType::String && std::get<String>(node.GetValue()) == "t5"; };
+
+  std::vector<Json*> sequential;
+  std::vector<Json*> parallel;
+  json->FindAllIf(predicate, sequential);
+  json->FindAllIf(pool, predicate, parallel);
+
+  EXPECT_EQ(sequential.size(), 20000 / 7);
+  EXPECT_EQ(parallel, sequential);
+
+  for (Integer id : { 0, 1, 4999, 5000, 19999 })
+  {
+    auto found = json->FindIf(pool, [id](const Json& node) { return IsId(node, id); });
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->GetInt64(), id);
+  }
+
+  EXPECT_EQ(json->FindIf(pool, [](const Json& node) { return IsId(node, 20000); }), nullptr);
+}
+
+TEST_F(SearchTests, ParallelFindIfPrefersEarliestMatch) {
+  ThreadPool pool(4);
+  auto json = MakeLarge(20000);
+
+  // Every element matches, the first one in document order must win
+  std::atomic<size_t> calls{ 0 };
+  auto found = json->FindIf(pool, [&calls](const Json& node) {
+    calls++;
+    return node.GetKey() == "id" && node.GetInt64() % 1000 == 999;
+    });
+
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->GetInt64(), 999);
+  EXPECT_LT(calls, 20000 * 4);
+}
+
+TEST_F(SearchTests, ParallelSearchFromTaskOfSamePool) {
+  ThreadPool pool(1);
+  auto json = MakeLarge(20000);
+
+  // The only worker runs the ranges of its own search while it waits for them
+  Json* found = nullptr;
+  pool.Submit([&]() { found = json->FindIf(pool, [](const Json& node) { return IsId(node, 12345); }); });
+  pool.Wait();
+
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->GetInt64(), 12345);
+}
+
+TEST_F(SearchTests, FindAllIfOrders) {
+  auto json = Json::Parse(R"({"a":{"a":1,"b":{"a":2}},"c":{"a":3}})");
+  auto predicate = [](const Json& node) { return node.GetKey() == "a"; };
+
+  auto a = (*json)["a"];
+  auto c = (*json)["c"];
+
+  // The list keeps the children first order of the former recursive search
+  auto list = json->FindAllIf(predicate);
+  EXPECT_EQ(std::vector<Json*>(list.begin(), list.end()), (std::vector<Json*>{ (*a)["a"], (*(*a)["b"])["a"], a, (*c)["a"] }));
+
+  std::vector<Json*> found;
+  json->FindAllIf(predicate, found);
+  EXPECT_EQ(found, (std::vector<Json*>{ a, (*a)["a"], (*(*a)["b"])["a"], (*c)["a"] }));
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "json_sax.h"
+#include "thread_pool.h"
+
+class SearchTests : public testing::Test
+{
+protected:
+  /* Array of objects with an id and a nested list, large enough for the parallel search */
+  static std::unique_ptr<Json> MakeLarge(size_t count)
+  {
+    std::string data = "[";
+    for (size_t i = 0; i < count; i++)
+    {
+      if (i > 0) data += ",";
+      data += "{\"id\":" + std::to_string(i) + ",\"tags\":[\"t" + std::to_string(i % 7) + "\"]}";
+    }
+    data += "]";
+
+    return Json::Parse(data);
+  }
+
+  static bool IsId(const Json& json, Integer id)
+  {
+    return json.GetKey() == "id" && json.GetInt64() == id;
+  }
+};
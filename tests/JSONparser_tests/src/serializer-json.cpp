@@ -0,0 +1,151 @@
+#include <cmath>
+#include <limits>
+
+#include "serializer-json.h"
+
+TEST_F(SerializerTests, RootValuesHaveNoKey) {
+  EXPECT_EQ(Json::Parse(R"([1,"a",true,null])")->ToString(), R"([1,"a",true,null])");
+  EXPECT_EQ(Json::Parse(R"({"a":[],"b":{}})")->ToString(), R"({"a":[],"b":{}})");
+
+  Json json;
+  json.SetValue("text");
+  EXPECT_EQ(json.ToString(), R"("text")");
+}
+
+TEST_F(SerializerTests, StringsAreEscaped) {
+  Json json;
+  json.AddChild(std::string("quote \" backslash \\ line\nbreak\ttab \x01 end"), "key \"quoted\"");
+
+  EXPECT_EQ(json.ToString(), R"({"key \"quoted\"":"quote \" backslash \\ line\nbreak\ttab \u0001 end"})");
+}
+
+TEST_F(SerializerTests, EscapedStringsRoundTrip) {
+  Json json;
+  json.AddValue(std::string("a\x01" "b\x1f"));
+
+  auto data = json.ToString();
+  EXPECT_EQ(data, R"(["a\u0001b\u001f"])");
+  EXPECT_EQ(std::get<String>((*Json::Parse(data))[0]->GetValue()), "a\x01" "b\x1f");
+  EXPECT_EQ(std::get<String>((*Json::Parse(data))[0]->GetValue()), "a\x01" "b\x1f");
+  EXPECT_EQ(JsonLazy::Parse(data)->GetRoot()[0].GetString(), "a\x01" "b\x1f");
+
+  // Escapes cut by chunk boundaries, surrogate pairs are decoded as one character
+  JsonParser parser;
+  parser.Start();
+  for (auto ch : std::string(R"(["\u00e9\/\uD83D\uDE00"])")) ASSERT_TRUE(parser.Feed(std::string_view(&ch, 1)));
+  EXPECT_EQ(std::get<String>((*parser.Finish())[0]->GetValue()), "\xC3\xA9/\xF0\x9F\x98\x80");
+
+  for (auto invalid : { R"(["\uD800"])", R"(["\uDC00\uD800"])", R"(["\u12G4"])", R"(["\u12"])" })
+  {
+    EXPECT_EQ(Json::Parse(invalid)->GetType(), Json::ValueType::Undefined) << invalid;
+    EXPECT_EQ(Json::Parse(invalid)->GetType(), Json::ValueType::Undefined) << invalid;
+  }
+}
+
+TEST_F(SerializerTests, LongStringsAreEscaped) {
+  std::string value(1000, 'x');
+  value[17] = '"';
+  value[500] = '\n';
+  value[999] = '\\';
+
+  Json json;
+  json.AddValue(value);
+
+  std::string expected = value;
+  expected.replace(999, 1, "\\\\");
+  expected.replace(500, 1, "\\n");
+  expected.replace(17, 1, "\\\"");
+  EXPECT_EQ(json.ToString(), "[\"" + expected + "\"]");
+}
+
+TEST_F(SerializerTests, NumbersRoundTrip) {
+  Json json;
+  json.AddValue(0.1);
+  json.AddValue(0.1 + 0.2);
+  json.AddValue(1e300);
+  json.AddValue(3.0);
+  json.AddValue(-2.5e-8);
+  json.AddValue(std::numeric_limits<double>::quiet_NaN());
+  json.AddValue(int64_t(-42));
+  json.AddValue(uint64_t(18446744073709551615ull));
+
+  auto text = json.ToString();
+  EXPECT_EQ(text, "[0.1,0.30000000000000004,1e+300,3.0,-2.5e-08,null,-42,18446744073709551615]");
+
+  auto parsed = Json::Parse(text);
+  ASSERT_EQ(parsed->GetType(), Json::ValueType::Array);
+  EXPECT_EQ((*parsed)[1]->GetNumber(), 0.1 + 0.2);
+  EXPECT_FALSE((*parsed)[3]->IsInteger());
+  EXPECT_EQ(parsed->ToString(), text);
+}
+
+TEST_F(SerializerTests, NegativeZeroKeepsItsSign) {
+  auto parsed = Json::Parse("[-0,-0.0,0,-0e1]");
+  ASSERT_EQ(parsed->GetType(), Json::ValueType::Array);
+
+  EXPECT_FALSE((*parsed)[0]->IsInteger());
+  EXPECT_TRUE(std::signbit((*parsed)[0]->GetNumber()));
+  EXPECT_TRUE((*parsed)[2]->IsInteger());
+
+  auto text = parsed->ToString();
+  EXPECT_EQ(text, "[-0.0,-0.0,0,-0.0]");
+  EXPECT_EQ(Json::Parse(text)->ToString(), text);
+  EXPECT_EQ(JsonTape::Parse("[-0]")->ToString(), "[-0.0]");
+}
+
+TEST_F(SerializerTests, DeepDocumentsRoundTrip) {
+  std::string data = std::string(200000, '[') + R"({"a":1})" + std::string(200000, ']');
+
+  // Containers are tracked on the heap, depth does not reach the call stack
+  auto json = Json::Parse(data);
+  ASSERT_TRUE(json->IsValid());
+  EXPECT_EQ(json->ToString(), data);
+
+  std::string written;
+  EXPECT_TRUE(json->WriteTo([&written](std::string_view chunk) { written += chunk; return true; }));
+  EXPECT_EQ(written, data);
+}
+
+TEST_F(SerializerTests, PrettyOutput) {
+  std::string data = R"({"name":"value","list":[1,{"nested":true},[]],"empty":{}})";
+  SerializeOptions options{ .pretty = true, .indent = 2 };
+
+  std::string expected = "{\n"
+    "  \"name\": \"value\",\n"
+    "  \"list\": [\n"
+    "    1,\n"
+    "    {\n"
+    "      \"nested\": true\n"
+    "    },\n"
+    "    []\n"
+    "  ],\n"
+    "  \"empty\": {}\n"
+    "}";
+
+  EXPECT_EQ(Json::Parse(data)->ToString(options), expected);
+  EXPECT_EQ(JsonTape::Parse(data)->ToString(options), expected);
+  EXPECT_EQ(JsonCompact::Parse(data)->ToString(options), expected);
+  EXPECT_EQ(Json::Parse(expected)->ToString(), data);
+}
+
+TEST_F(SerializerTests, DocumentTypesAgree) {
+  std::string data = R"({"s":"a\"b","d":12.25,"i":-3,"u":18446744073709551615,"l":[true,false,null]})";
+
+  auto expected = Json::Parse(data)->ToString();
+  EXPECT_EQ(expected, data);
+  EXPECT_EQ(JsonTape::Parse(data)->ToString(), expected);
+  EXPECT_EQ(JsonCompact::Parse(data)->ToString(), expected);
+}
+
+TEST_F(SerializerTests, AppendsToExistingOutput) {
+  std::string output = "prefix ";
+  {
+    JsonSerializer serializer(output);
+    serializer.StartArray();
+    serializer.WriteNumber(Integer(1));
+    serializer.WriteString("two");
+    serializer.EndArray();
+  }
+
+  EXPECT_EQ(output, R"(prefix [1,"two"])");
+}
@@ -0,0 +1,15 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include "json.h"
+#include "json_compact.h"
+#include "json_lazy.h"
+#include "json_parser.h"
+#include "json_serializer.h"
+#include "json_tape.h"
+
+class SerializerTests : public testing::Test
+{
+protected:
+
+};
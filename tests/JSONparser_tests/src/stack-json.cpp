@@ -0,0 +1,113 @@
+#include "stack-json.h"
+
+TEST_F(StackParserTests, BuildsSameTreeAsTape) {
+  std::vector<std::string> documents = {
+    R"({"name":"value","number":-12.5e3,"int":42,"big":18446744073709551615,"flags":[true,false,null]})",
+    R"([1,[2,[3,[4]]],{"a":{"b":{"c":"d"}}}])",
+    R"({"text":"line\nbreak \"quoted\" A","list":[{"x":1},{"y":2}]})",
+    " \n\t{ \"spaced\" : [ 1 , 2 ] , \"next\" : { \"k\" : \"v\" } } \n",
+  };
+
+  for (auto& data : documents)
+  {
+    auto expected = JsonTape::Parse(data);
+    auto json = ParseStack(data);
+
+    ASSERT_TRUE(json->IsValid()) << data;
+    EXPECT_EQ(json->ToString(), expected->ToString()) << data;
+  }
+}
+
+TEST_F(StackParserTests, EmptyContainers) {
+  auto json = ParseStack(R"({"a":[],"b":{},"c":[[],{}]})");
+
+  ASSERT_TRUE(json->IsValid());
+  EXPECT_EQ(json->ToString(), R"({"a":[],"b":{},"c":[[],{}]})");
+  EXPECT_EQ(ParseStack("[]")->ToString(), "[]");
+  EXPECT_EQ(ParseStack("{}")->ToString(), "{}");
+}
+
+TEST_F(StackParserTests, RejectsMalformedInput) {
+  std::vector<std::string> documents = {
+    "", "1", "\"text\"", "{", "[1,2", "{\"a\" 1}", "{\"a\":}", "[1,]", "{\"a\":tru}", "[1] x", "{1:2}", "[1}", "{\"a\":1]",
+  };
+
+  for (auto& data : documents)
+  {
+    ParseError error = ParseError::None;
+    auto json = Json::Parse(data, StackOptions(), error);
+
+    EXPECT_FALSE(json->IsValid()) << data;
+    EXPECT_EQ(error, ParseError::Syntax) << data;
+  }
+}
+
+TEST_F(StackParserTests, DeepDocumentsDoNotUseTheStack) {
+  constexpr size_t depth = 1000000;
+  auto json = ParseStack(MakeNested(depth));
+  ASSERT_TRUE(json->IsValid());
+
+  size_t levels = 0;
+  const Json* node = json.get();
+  while (node->GetType() == Json::ValueType::Object || node->GetType() == Json::ValueType::Array)
+  {
+    levels++;
+    node = std::get<ChildrenList>(node->GetValue()).front().get();
+  }
+
+  EXPECT_EQ(levels, depth + depth / 2);
+  EXPECT_EQ(node->GetInt64(), 1);
+}
+
+TEST_F(StackParserTests, DeepDocumentsCopy) {
+  constexpr size_t depth = 100000;
+  auto data = MakeNested(depth);
+
+  ParseOptions options;
+  options.use_arena = true;
+  auto json = ParseStack(data, options);
+  ASSERT_TRUE(json->IsValid());
+
+  // Copies walk the tree from a worklist like the destructor does
+  Json copy(*json);
+  EXPECT_EQ(copy.ToString(), data);
+
+  // Assignment copies the value, the type of the target is kept
+  Json assigned;
+  assigned = copy;
+  auto& members = std::get<ChildrenList>(assigned.GetValue());
+  ASSERT_EQ(members.size(), 1);
+  EXPECT_EQ(members.front()->ToString(), copy["a"]->ToString());
+
+  auto detached = (*json)["a"]->Detach();
+  ASSERT_NE(detached, nullptr);
+  EXPECT_EQ(detached->ToString(), Json(*copy["a"]).ToString());
+}
+
+TEST_F(StackParserTests, LimitsApply) {
+  ParseOptions options = StackOptions();
+  options.max_depth = 10;
+
+  ParseError error = ParseError::None;
+  EXPECT_FALSE(Json::Parse(std::string(11, '[') + std::string(11, ']'), options, error)->IsValid());
+  EXPECT_EQ(error, ParseError::DepthLimit);
+  EXPECT_TRUE(Json::Parse(std::string(10, '[') + std::string(10, ']'), options, error)->IsValid());
+  EXPECT_EQ(error, ParseError::None);
+
+  options = StackOptions();
+  options.max_nodes = 3;
+  EXPECT_FALSE(Json::Parse("[1,2,3]", options, error)->IsValid());
+  EXPECT_EQ(error, ParseError::NodeLimit);
+}
+
+TEST_F(StackParserTests, ArenaAndInternedKeys) {
+  ParseOptions options = StackOptions();
+  options.use_arena = true;
+  options.intern_keys = true;
+
+  auto json = ParseStack(R"([{"id":1,"tag":"a"},{"id":2,"tag":"b"}])", options);
+
+  ASSERT_TRUE(json->IsValid());
+  EXPECT_EQ(json->ToString(), R"([{"id":1,"tag":"a"},{"id":2,"tag":"b"}])");
+  EXPECT_EQ(json->GetStringPool()->GetCount(), 2);
+}
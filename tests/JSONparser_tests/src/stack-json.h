@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "json_parser.h"
+#include "json_tape.h"
+
+class StackParserTests : public testing::Test
+{
+protected:
+  static ParseOptions StackOptions()
+  {
+    return ParseOptions();
+  }
+
+  static std::unique_ptr<Json> ParseStack(std::string_view data, const ParseOptions& options = StackOptions())
+  {
+    return Json::Parse(data, options);
+  }
+
+  static std::string MakeNested(size_t depth)
+  {
+    std::string data;
+    for (size_t i = 0; i < depth; i++) data += i % 2 == 0 ? "{\"a\":[" : "{\"b\":";
+    data += "1";
+    for (size_t i = depth; i > 0; i--) data += (i - 1) % 2 == 0 ? "]}" : "}";
+
+    return data;
+  }
+};
@@ -0,0 +1,209 @@
+#include "tape-json.h"
+
+TEST_F(TapeTests, EmptyObject) {
+  auto tape = JsonTape::Parse("{}");
+
+  ASSERT_TRUE(tape->IsValid());
+  EXPECT_EQ(tape->GetTapeSize(), 2);
+
+  auto root = tape->GetRoot();
+  EXPECT_EQ(root.GetType(), Json::ValueType::Object);
+  EXPECT_EQ(root.Size(), 0);
+}
+
+TEST_F(TapeTests, EmptyArrayWithWhitespaces) {
+  auto tape = JsonTape::Parse(R"(  
+ [ ]  
+ )");
+
+  ASSERT_TRUE(tape->IsValid());
+  EXPECT_EQ(tape->GetRoot().GetType(), Json::ValueType::Array);
+  EXPECT_EQ(tape->GetRoot().Size(), 0);
+}
+
+TEST_F(TapeTests, ObjectWithValidElements) {
+  auto tape = JsonTape::Parse(R"({ "string" : "value", "number" : 13.4, "true" : true, "false" : false, "null" : null })");
+
+  ASSERT_TRUE(tape->IsValid());
+  auto root = tape->GetRoot();
+  EXPECT_EQ(root.Size(), 5);
+
+  EXPECT_EQ(root["string"].GetType(), Json::ValueType::String);
+  EXPECT_EQ(root["string"].GetKey(), "string");
+  EXPECT_EQ(root["string"].GetString(), "value");
+
+  EXPECT_EQ(root["number"].GetType(), Json::ValueType::Number);
+  EXPECT_EQ(root["number"].GetNumber(), 13.4);
+
+  EXPECT_EQ(root["true"].GetType(), Json::ValueType::Bool);
+  EXPECT_TRUE(root["true"].GetBool());
+  EXPECT_EQ(root["false"].GetType(), Json::ValueType::Bool);
+  EXPECT_FALSE(root["false"].GetBool());
+  EXPECT_EQ(root["null"].GetType(), Json::ValueType::Null);
+
+  EXPECT_FALSE(root["missing"].IsValid());
+}
+
+TEST_F(TapeTests, ObjectWithNestedArrays) {
+  auto tape = JsonTape::Parse(R"({ "key1" : ["value1", 3.14, [{ "key" : "value"}, true]], "key2" : "last" })");
+
+  ASSERT_TRUE(tape->IsValid());
+  auto root = tape->GetRoot();
+
+  auto array = root["key1"];
+  EXPECT_EQ(array.GetType(), Json::ValueType::Array);
+  ASSERT_EQ(array.Size(), 3);
+  EXPECT_EQ(array[0].GetString(), "value1");
+  EXPECT_EQ(array[1].GetNumber(), 3.14);
+  EXPECT_EQ(array[2].Size(), 2);
+  EXPECT_EQ(array[2][0]["key"].GetString(), "value");
+  EXPECT_TRUE(array[2][1].GetBool());
+  EXPECT_FALSE(array[3].IsValid());
+  EXPECT_FALSE(array[-1].IsValid());
+
+  // Jump offsets skip the whole nested array
+  EXPECT_EQ(root["key2"].GetString(), "last");
+  EXPECT_EQ(root[1].GetKey(), "key2");
+}
+
+TEST_F(TapeTests, IndexedAccess) {
+  auto tape = JsonTape::Parse(R"([1,"two",[3,[3]],{"four":4},null,6.5,-7,true])");
+  ASSERT_TRUE(tape->IsValid());
+
+  // Elements of every size are skipped on the way to the requested one
+  auto root = tape->GetRoot();
+  EXPECT_EQ(root[0].GetInt64(), 1);
+  EXPECT_EQ(root[1].GetString(), "two");
+  EXPECT_EQ(root[2].Size(), 2);
+  EXPECT_EQ(root[3]["four"].GetInt64(), 4);
+  EXPECT_EQ(root[4].GetType(), Json::ValueType::Null);
+  EXPECT_EQ(root[5].GetNumber(), 6.5);
+  EXPECT_EQ(root[6].GetInt64(), -7);
+  EXPECT_TRUE(root[7].GetBool());
+  EXPECT_FALSE(root[8].IsValid());
+  EXPECT_EQ(root[3][0].GetKey(), "four");
+}
+
+TEST_F(TapeTests, DeepDocumentsRoundTrip) {
+  std::string data = std::string(100000, '[') + R"({"a":[1,{"b":{}}],"c":"d"})" + std::string(100000, ']');
+
+  // The tape is written out in one pass over its entries, without recursion
+  auto tape = JsonTape::Parse(data);
+  ASSERT_TRUE(tape->IsValid());
+  EXPECT_EQ(tape->ToString(), data);
+}
+
+TEST_F(TapeTests, ForEachChild) {
+  auto tape = JsonTape::Parse(R"({ "a" : 1, "b" : [2, 3], "c" : {} })");
+
+  std::string keys = "";
+  tape->GetRoot().ForEachChild([&keys](const JsonTape::Element& child) {
+    keys += child.GetKey();
+    });
+
+  EXPECT_EQ(keys, "abc");
+}
+
+TEST_F(TapeTests, ToString) {
+  auto tape = JsonTape::Parse(R"({ "key" : [ "value", true, null, {} ] })");
+
+  EXPECT_EQ(tape->ToString(), R"({"key":["value",true,null,{}]})");
+}
+
+TEST_F(TapeTests, InvalidDocuments) {
+  EXPECT_FALSE(JsonTape::Parse("")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("{")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(R"({ "key" 1 })")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(R"([1, 2,])")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(R"([tru])")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(R"({} {})")->IsValid());
+}
+
+TEST_F(TapeTests, LongAndEscapedStrings) {
+  std::string long_value(100, 'y');
+  auto tape = JsonTape::Parse(R"([ ")" + long_value + R"(", "\"quoted\" \\ and\nnew line", "unterminated \" ])");
+
+  EXPECT_FALSE(tape->IsValid());
+
+  tape = JsonTape::Parse(R"([ ")" + long_value + R"(", "\"quoted\" \\ and\nnew line" ])");
+  ASSERT_TRUE(tape->IsValid());
+  EXPECT_EQ(tape->GetRoot()[0].GetString(), long_value);
+  EXPECT_EQ(tape->GetRoot()[1].GetString(), "\"quoted\" \\ and\nnew line");
+}
+
+TEST_F(TapeTests, InvalidNumbers) {
+  EXPECT_TRUE(JsonTape::Parse("[-0, 10, 1.5e3]")->IsValid());
+
+  EXPECT_FALSE(JsonTape::Parse("[01]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[-]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1.]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[.5]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1e]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1e+]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[+1]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1.5.3]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[12abc]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1-2]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1e400]")->IsValid());
+}
+
+TEST_F(TapeTests, OutOfRangeNumbers) {
+  // Below the smallest subnormal the value rounds to a signed zero
+  auto tape = JsonTape::Parse("[1e-400,-2e-400,4.9e-324,0.0000001e-320,1" + std::string(400, '0') + "e-800]");
+  ASSERT_TRUE(tape->IsValid());
+
+  auto root = tape->GetRoot();
+  EXPECT_EQ(root[0].GetNumber(), 0.0);
+  EXPECT_FALSE(std::signbit(root[0].GetNumber()));
+  EXPECT_EQ(root[1].GetNumber(), 0.0);
+  EXPECT_TRUE(std::signbit(root[1].GetNumber()));
+  EXPECT_GT(root[2].GetNumber(), 0.0);
+  EXPECT_EQ(root[3].GetNumber(), 0.0);
+  EXPECT_EQ(root[4].GetNumber(), 0.0);
+  EXPECT_TRUE(Json::Parse("[1e-400,-2e-400]")->IsValid());
+
+  // Past the largest double there is no value to keep, the literal is rejected
+  EXPECT_FALSE(JsonTape::Parse("[-1e400]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[1" + std::string(400, '0') + "e-50]")->IsValid());
+  EXPECT_FALSE(JsonTape::Parse("[0.0001e99999999999999999999]")->IsValid());
+  EXPECT_FALSE(Json::Parse("[1e400]")->IsValid());
+}
+
+TEST_F(TapeTests, LargeIntegers) {
+  auto tape = JsonTape::Parse(R"({"big":9007199254740993,"max":18446744073709551615,"min":-9223372036854775808,"pi":3.5})");
+  ASSERT_TRUE(tape->IsValid());
+
+  auto root = tape->GetRoot();
+  EXPECT_TRUE(root["big"].IsInteger());
+  EXPECT_EQ(root["big"].GetInt64(), 9007199254740993);
+  EXPECT_EQ(root["max"].GetUInt64(), 18446744073709551615ull);
+  EXPECT_EQ(root["min"].GetInt64(), INT64_MIN);
+  EXPECT_FALSE(root["pi"].IsInteger());
+  EXPECT_EQ(root["pi"].GetNumber(), 3.5);
+
+  EXPECT_EQ(tape->ToString(), R"({"big":9007199254740993,"max":18446744073709551615,"min":-9223372036854775808,"pi":3.5})");
+}
+
+TEST_F(TapeTests, ZeroCopyStrings) {
+  std::string data = R"({"plain":"value","escaped":"line\nbreak \"quoted\"","array":["a","b\\c"]})";
+  auto copied = JsonTape::Parse(data);
+  auto tape = JsonTape::Parse(std::move(data));
+
+  ASSERT_TRUE(tape->IsValid());
+  auto root = tape->GetRoot();
+
+  EXPECT_EQ(root["plain"].GetKey(), "plain");
+  EXPECT_EQ(root["plain"].GetString(), "value");
+  EXPECT_EQ(root["escaped"].GetString(), "line\nbreak \"quoted\"");
+  EXPECT_EQ(root["escaped"].GetString(), "line\nbreak \"quoted\"");
+  EXPECT_EQ(root["array"][1].GetString(), "b\\c");
+
+  EXPECT_EQ(tape->ToString(), copied->ToString());
+}
+
+TEST_F(TapeTests, ZeroCopyInvalidStrings) {
+  EXPECT_FALSE(JsonTape::Parse(std::string(R"(["unterminated \"])"))->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(std::string(R"(["invalid \x escape"])"))->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(std::string("[\"raw\nnew line\"]"))->IsValid());
+  EXPECT_FALSE(JsonTape::Parse(std::string(R"(["trailing \)"))->IsValid());
+}
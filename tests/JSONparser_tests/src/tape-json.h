@@ -0,0 +1,10 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include "json_tape.h"
+
+class TapeTests : public testing::Test
+{
+protected:
+
+};
@@ -2,5 +2,25 @@
 #define TEST_SUITES_H
 
 #include "parsing-json.h"
+#include "arena-json.h"
+#include "tape-json.h"
+#include "index-json.h"
+#include "file-json.h"
+#include "push-json.h"
+#include "sax-json.h"
+#include "lines-json.h"
+#include "parallel-json.h"
+#include "keys-json.h"
+#include "intern-json.h"
+#include "compact-json.h"
+#include "serializer-json.h"
+#include "writer-json.h"
+#include "progress-json.h"
+#include "limits-json.h"
+#include "stack-json.h"
+#include "pointer-json.h"
+#include "search-json.h"
+#include "ranges-json.h"
+#include "lazy-json.h"
 
 #endif // !TEST_SUITES_H
@@ -0,0 +1,101 @@
+#include "writer-json.h"
+
+TEST_F(WriterTests, CallbackReceivesBoundedChunks) {
+  auto json = MakeLarge();
+  std::string expected = json->ToString();
+
+  std::string output;
+  std::vector<size_t> chunks;
+  bool result = json->WriteTo([&](std::string_view chunk) {
+    chunks.push_back(chunk.size());
+    output.append(chunk);
+    return true;
+    });
+
+  EXPECT_TRUE(result);
+  EXPECT_EQ(output, expected);
+  EXPECT_GT(chunks.size(), 1);
+  for (auto size : chunks) EXPECT_LE(size, JSON_WRITE_BUFFER_SIZE);
+}
+
+TEST_F(WriterTests, LongStringsBypassTheBuffer) {
+  Json json;
+  json.AddChild(std::string(3 * JSON_WRITE_BUFFER_SIZE, 'x'), "long");
+
+  std::string output;
+  EXPECT_TRUE(json.WriteTo([&](std::string_view chunk) { output.append(chunk); return true; }));
+  EXPECT_EQ(output, json.ToString());
+}
+
+TEST_F(WriterTests, FailingCallbackIsReported) {
+  auto json = MakeLarge();
+
+  int calls = 0;
+  bool result = json->WriteTo([&](std::string_view /*chunk*/) {
+    calls++;
+    return false;
+    });
+
+  EXPECT_FALSE(result);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(WriterTests, WritesToFile) {
+  auto json = MakeLarge();
+  FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+
+  EXPECT_TRUE(json->WriteTo(file, SerializeOptions{ true, 4 }));
+  std::fflush(file);
+  EXPECT_EQ(ReadAll(file), json->ToString(SerializeOptions{ true, 4 }));
+
+  std::fclose(file);
+}
+
+TEST_F(WriterTests, WritesToDescriptor) {
+  auto json = MakeLarge();
+  FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+
+  EXPECT_TRUE(json->WriteTo(fileno(file)));
+  EXPECT_EQ(ReadAll(file), json->ToString());
+
+  std::fclose(file);
+}
+
+TEST_F(WriterTests, InvalidDescriptorFails) {
+  Json json;
+  json.AddValue(1);
+
+  EXPECT_FALSE(json.WriteTo(-1));
+}
+
+TEST_F(WriterTests, WriterBuildsDocument) {
+  auto embedded = Json::Parse(R"({"x":[1,2],"y":null})");
+
+  std::string output;
+  JsonWriter writer(output);
+  writer.StartObject()
+    .Member("name", "writer")
+    .Member("count", 3)
+    .Member("ratio", 0.5)
+    .Member("ok", true)
+    .Key("none").Null()
+    .Key("list").StartArray().Value(1u).Value("two").EndArray()
+    .Member("embedded", *embedded)
+    .EndObject();
+
+  EXPECT_TRUE(writer.Finish());
+  EXPECT_EQ(output, R"({"name":"writer","count":3,"ratio":0.5,"ok":true,"none":null,"list":[1,"two"],"embedded":{"x":[1,2],"y":null}})");
+  EXPECT_EQ(Json::Parse(output)->ToString(), output);
+}
+
+TEST_F(WriterTests, WriterStreamsPrettyOutput) {
+  std::string output;
+  JsonWriter writer([&](std::string_view chunk) { output.append(chunk); return true; }, SerializeOptions{ true, 2 });
+
+  writer.StartArray().Value(1).StartObject().Member("a", "b").EndObject().EndArray();
+  EXPECT_TRUE(writer.Finish());
+
+  EXPECT_EQ(output, "[\n  1,\n  {\n    \"a\": \"b\"\n  }\n]");
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "json_serializer.h"
+#include "json_writer.h"
+
+class WriterTests : public testing::Test
+{
+protected:
+  static std::string ReadAll(FILE* file)
+  {
+    std::string content;
+    char buffer[4096];
+
+    std::rewind(file);
+    for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), file)) > 0;) content.append(buffer, read);
+
+    return content;
+  }
+
+  static std::unique_ptr<Json> MakeLarge()
+  {
+    auto json = std::make_unique<Json>();
+    for (int i = 0; i < 20000; i++) json->AddChild(std::string("value \"") + std::to_string(i), "key" + std::to_string(i));
+
+    return json;
+  }
+};